@@ -1,6 +1,7 @@
 #ifndef FF2408FE_6542_4CBE_B7CB_1CC00ECE539D
 #define FF2408FE_6542_4CBE_B7CB_1CC00ECE539D
 
+#include <endian.h>
 #include <stdint.h>
 
 enum npy_endianness
@@ -11,16 +12,10 @@ enum npy_endianness
     not_applicable = '|'
 };
 
-static union word_struct
+// The byte order of the machine is known at compile time, so it can be used in constant expressions.
+constexpr npy_endianness get_endianess() noexcept
 {
-    uint32_t integer_value;
-    uint8_t byte_values[4];
-} word = {0x10203040};
-
-npy_endianness get_endianess()
-{
-    static npy_endianness machine_endianess = word.byte_values[0] == 0x10 ? npy_endianness::big_endian : npy_endianness::little_endian;
-    return machine_endianess;
+    return __BYTE_ORDER == __BIG_ENDIAN ? npy_endianness::big_endian : npy_endianness::little_endian;
 }
 
 #endif /* FF2408FE_6542_4CBE_B7CB_1CC00ECE539D */
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef A2E7C9F4_5B18_4D63_9C2E_7F4A1B8D3E56
+#define A2E7C9F4_5B18_4D63_9C2E_7F4A1B8D3E56
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Accessor of the elements of an array of N dimensions, whose shape and strides are held in fixed-size arrays.
+ *
+ * The rank being known at compile time, the offset of an element is a sum of N products that the compiler fully unrolls,
+ * and keeps in registers across the iterations of a loop, instead of walking the strides vector of npy_array.
+ * An accessor refers to the payload of the array, it must not outlive it.
+ *
+ * @tparam T the type of the elements, const T for a read-only accessor.
+ * @tparam N the number of dimensions.
+ */
+template<typename T, size_t N>
+class npy_accessor
+{
+    static_assert(N > 0, "An accessor has at least one dimension.");
+
+public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef size_t size_type;
+
+    npy_accessor(T* data, const std::array<size_type, N>& shape, const std::array<size_type, N>& strides) noexcept
+        : _data{data}, _shape(shape), _strides(strides) {}
+
+    /**
+     * @brief The element at the given indexes, one for each dimension, without bounds checking.
+     */
+    template<typename... Indexes>
+    reference operator()(Indexes... indexes) const noexcept
+    {
+        static_assert(sizeof...(Indexes) == N, "The number of indexes must match the number of dimensions.");
+
+        const size_type values[N] = {static_cast<size_type>(indexes)...};
+        size_type offset = 0;
+
+        for(size_type i = 0; i < N; i++)
+        {
+            offset += values[i] * _strides[i];
+        }
+
+        return _data[offset];
+    }
+
+    /**
+     * @brief The element at the given indexes, one for each dimension.
+     *
+     * @throw std::out_of_range if an index is out of its dimension.
+     */
+    template<typename... Indexes>
+    reference at(Indexes... indexes) const
+    {
+        static_assert(sizeof...(Indexes) == N, "The number of indexes must match the number of dimensions.");
+
+        const size_type values[N] = {static_cast<size_type>(indexes)...};
+
+        for(size_type i = 0; i < N; i++)
+        {
+            if(values[i] >= _shape[i]) throw std::out_of_range{"Index " + std::to_string(values[i]) + " is out of range " + std::to_string(_shape[i]) + " of the dimension " + std::to_string(i)};
+        }
+
+        return (*this)(indexes...);
+    }
+
+    const std::array<size_type, N>& shape() const noexcept {return _shape;}
+    const std::array<size_type, N>& strides() const noexcept {return _strides;}
+    T* data() const noexcept {return _data;}
+
+private:
+    T* _data;
+    std::array<size_type, N> _shape;
+    std::array<size_type, N> _strides;
+};
+
+#endif /* A2E7C9F4_5B18_4D63_9C2E_7F4A1B8D3E56 */
@@ -0,0 +1,142 @@
+#ifndef C1F8A4D6_3E59_4B27_9A6C_2D7E5B8F1A93
+#define C1F8A4D6_3E59_4B27_9A6C_2D7E5B8F1A93
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief The size in bytes of a transparent huge page.
+ */
+const size_t npy_huge_page_size = 2 << 20;
+
+/**
+ * @brief Allocate size bytes aligned to alignment, which must be a power of two multiple of sizeof(void*).
+ *
+ * @throw std::bad_alloc if the memory cannot be allocated.
+ */
+void* npy_aligned_allocate(size_t size, size_t alignment);
+/**
+ * @brief Release the memory allocated by npy_aligned_allocate().
+ */
+void npy_aligned_deallocate(void* pointer) noexcept;
+
+/**
+ * @brief Allocate size bytes backed by transparent huge pages.
+ *
+ * The memory is mapped in multiples of npy_huge_page_size, aligned to npy_huge_page_size,
+ * and the kernel is advised to back it with huge pages: the TLB then covers 2 MiB with a single entry.
+ * Allocations smaller than a huge page are 64 bytes aligned allocations from the heap instead.
+ *
+ * @throw std::bad_alloc if the memory cannot be allocated.
+ */
+void* npy_huge_page_allocate(size_t size);
+/**
+ * @brief Release the memory allocated by npy_huge_page_allocate() with the same size.
+ */
+void npy_huge_page_deallocate(void* pointer, size_t size) noexcept;
+
+/**
+ * @brief Allocator of memory aligned to Alignment bytes, 64 by default to match the size of a cache line and of an AVX-512 register.
+ *
+ * It can be used as the Allocator of npy_array, like npy_array<float, npy_aligned_allocator<float>>.
+ *
+ * @tparam T the type of the elements.
+ * @tparam Alignment the alignment in bytes, a power of two at least alignof(T).
+ */
+template<typename T, size_t Alignment = 64>
+class npy_aligned_allocator
+{
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef npy_aligned_allocator<U, Alignment> other;
+    };
+
+    npy_aligned_allocator() noexcept = default;
+    template<typename U>
+    npy_aligned_allocator(const npy_aligned_allocator<U, Alignment>& other) noexcept {}
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(npy_aligned_allocate(count * sizeof(T), Alignment < sizeof(void*) ? sizeof(void*) : Alignment));
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {npy_aligned_deallocate(pointer);}
+
+    template<typename U>
+    bool operator==(const npy_aligned_allocator<U, Alignment>& other) const noexcept {return true;}
+    template<typename U>
+    bool operator!=(const npy_aligned_allocator<U, Alignment>& other) const noexcept {return false;}
+};
+
+/**
+ * @brief Allocator of memory backed by 2 MiB transparent huge pages, see npy_huge_page_allocate().
+ *
+ * It can be used as the Allocator of npy_array, like npy_array<float, npy_huge_page_allocator<float>>,
+ * to reduce the TLB misses of random accesses to huge arrays.
+ *
+ * @tparam T the type of the elements.
+ */
+template<typename T>
+class npy_huge_page_allocator
+{
+public:
+    typedef T value_type;
+
+    npy_huge_page_allocator() noexcept = default;
+    template<typename U>
+    npy_huge_page_allocator(const npy_huge_page_allocator<U>& other) noexcept {}
+
+    T* allocate(size_t count) {return static_cast<T*>(npy_huge_page_allocate(count * sizeof(T)));}
+    void deallocate(T* pointer, size_t count) noexcept {npy_huge_page_deallocate(pointer, count * sizeof(T));}
+
+    template<typename U>
+    bool operator==(const npy_huge_page_allocator<U>& other) const noexcept {return true;}
+    template<typename U>
+    bool operator!=(const npy_huge_page_allocator<U>& other) const noexcept {return false;}
+};
+
+/**
+ * @brief Adaptor of the allocator A default-initializing, instead of value-initializing, the elements constructed without arguments.
+ *
+ * A std::vector using it does not zero-fill the elements added by resize(), which suits the buffers that are overwritten right away,
+ * like a payload read from a file: the memory is then written once instead of twice.
+ * The elements constructed with arguments are constructed by A as usual.
+ *
+ * @tparam A the adapted allocator.
+ */
+template<typename A>
+class npy_default_init_allocator : public A
+{
+public:
+    template<typename U>
+    struct rebind
+    {
+        typedef npy_default_init_allocator<typename std::allocator_traits<A>::template rebind_alloc<U>> other;
+    };
+
+    npy_default_init_allocator() noexcept(std::is_nothrow_default_constructible<A>::value) = default;
+    template<typename U>
+    npy_default_init_allocator(const U& other) noexcept : A(other) {}
+
+    template<typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new(static_cast<void*>(pointer)) U;
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* pointer, Args&&... args)
+    {
+        std::allocator_traits<A>::construct(static_cast<A&>(*this), pointer, std::forward<Args>(args)...);
+    }
+};
+
+#endif /* C1F8A4D6_3E59_4B27_9A6C_2D7E5B8F1A93 */
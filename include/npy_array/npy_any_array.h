@@ -0,0 +1,130 @@
+#ifndef B7D2E5A9_4C18_4F63_A2E7_8D5B3F0C1A96
+#define B7D2E5A9_4C18_4F63_A2E7_8D5B3F0C1A96
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "npy_array/npy_array.h"
+#include "npy_array/npy_dtype.h"
+#include "npy_array/npy_exception.h"
+#include "npy_array/npy_header.h"
+
+/**
+ * @brief An array whose dtype is known only at runtime.
+ *
+ * A npy_any_array opens any file having a supported dtype in a single pass: the header is read once,
+ * and the payload is loaded, or mapped, as the npy_array of the matching C++ type.
+ * The payload is then reachable either as raw bytes, through data() and byte_size(),
+ * or as the typed npy_array, through the checked cast as<T>() or through visit(),
+ * which dispatches the typed array to a generic callable.
+ * A payload having the non-native byte order is swapped while it is loaded, like npy_array does.
+ *
+ * Errors are reported as npy_array_exception, as npy_array does.
+ */
+class npy_any_array
+{
+public:
+    typedef size_t size_type;
+
+    /**
+     * @brief Open the array file at the given path, whatever its dtype.
+     *
+     * @param array_path the path of the file.
+     * @param mode how the payload is made available, see npy_array_mode.
+     * @throw npy_array_exception unsupported_dtype if the dtype has no C++ type, or the errors of npy_array.
+     */
+    npy_any_array(const std::string& array_path, npy_array_mode mode = npy_array_mode::load_in_memory);
+
+    /**
+     * @brief Wrap a typed array, without copying its payload.
+     */
+    template<typename T>
+    npy_any_array(npy_array<T>&& array);
+
+    npy_any_array(const npy_any_array& other);
+    npy_any_array(npy_any_array&& other) noexcept = default;
+
+    ~npy_any_array() = default;
+
+    npy_any_array& operator=(const npy_any_array& other);
+    npy_any_array& operator=(npy_any_array&& other) noexcept = default;
+
+    const npy_dtype& dtype() const noexcept;
+    const std::vector<size_type>& shape() const noexcept;
+    bool fortran_order() const noexcept;
+    bool mapped() const noexcept;
+
+    void* data() noexcept;
+    const void* data() const noexcept;
+
+    size_type size() const noexcept;
+    size_type byte_size() const noexcept;
+
+    /**
+     * @brief Whether the elements have the C++ type T.
+     */
+    template<typename T>
+    bool is() const noexcept;
+
+    /**
+     * @brief The typed array, if the elements have the C++ type T.
+     *
+     * @throw npy_array_exception unsupported_dtype if the elements do not have the C++ type T.
+     */
+    template<typename T>
+    npy_array<T>& as();
+    template<typename T>
+    const npy_array<T>& as() const;
+
+    /**
+     * @brief Call the visitor with the typed array, as visitor(npy_array<T>&).
+     *
+     * The visitor is usually a generic lambda, and it must return the same type for every T.
+     * The 8-bit signed integer arrays are visited as npy_array<int8_t>.
+     */
+    template<typename Visitor>
+    auto visit(Visitor&& visitor) -> decltype(visitor(std::declval<npy_array<bool>&>()));
+    template<typename Visitor>
+    auto visit(Visitor&& visitor) const -> decltype(visitor(std::declval<const npy_array<bool>&>()));
+
+    void save(const std::string& array_path, npy_endianness byte_order = npy_endianness::native) const;
+
+private:
+    // The type-erased interface of the typed array held.
+    struct holder_base
+    {
+        virtual ~holder_base() = default;
+        virtual std::unique_ptr<holder_base> clone() const = 0;
+        virtual const npy_dtype& dtype() const noexcept = 0;
+        virtual const std::vector<size_type>& shape() const noexcept = 0;
+        virtual bool fortran_order() const noexcept = 0;
+        virtual bool mapped() const noexcept = 0;
+        virtual void* data() noexcept = 0;
+        virtual size_type size() const noexcept = 0;
+    };
+
+    template<typename T>
+    struct holder : holder_base
+    {
+        explicit holder(npy_array<T>&& held_array);
+
+        std::unique_ptr<holder_base> clone() const override;
+        const npy_dtype& dtype() const noexcept override;
+        const std::vector<size_type>& shape() const noexcept override;
+        bool fortran_order() const noexcept override;
+        bool mapped() const noexcept override;
+        void* data() noexcept override;
+        size_type size() const noexcept override;
+
+        npy_array<T> array;
+    };
+
+    std::unique_ptr<holder_base> _holder;
+};
+
+#include "npy_array/npy_any_array.ipp"
+
+#endif /* B7D2E5A9_4C18_4F63_A2E7_8D5B3F0C1A96 */
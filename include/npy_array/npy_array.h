@@ -2,52 +2,215 @@
 #define D95166DE_89E6_49FF_A7EA_BA27F7948D32
 
 #include <vector>
+#include <cassert>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <iostream>
 #include <iomanip>
 #include <stdint.h>
-#include <boost/algorithm/string/split.hpp>
 #include <algorithm>
 #include <numeric>
 #include <functional>
+#include <future>
 #include <endian.h>
 #include <array>
 #include <initializer_list>
+#include <limits>
+#include <memory>
+#include <type_traits>
 
 #include "npy_array/endianess.h"
+#include "npy_array/npy_accessor.h"
+#include "npy_array/npy_allocator.h"
+#include "npy_array/npy_byteswap.h"
+#include "npy_array/npy_convert.h"
+#include "npy_array/npy_direct_io.h"
 #include "npy_array/npy_exception.h"
 #include "npy_array/npy_dtype.h"
+#include "npy_array/npy_header.h"
+#include "npy_array/npy_mapping.h"
+#include "npy_array/npy_thread_pool.h"
+#include "npy_array/npy_transpose.h"
 
-template<typename T>
+/**
+ * @brief How the payload of an array file is made available to the npy_array.
+ *
+ * load_in_memory: the payload is read into memory owned by the array.
+ * map_read_only: the file is memory-mapped read-only and the array refers directly to the mapping,
+ * the payload pages are shared with every other process mapping the same file.
+ * Writing to an array opened with map_read_only raises a segmentation fault.
+ * map_read_write: the file is memory-mapped read-write, every assignment to the array lands directly in the file.
+ * Use sync() to make the modifications durable.
+ * load_c_order: like load_in_memory, but a payload stored in Fortran order is transposed to C order while loading.
+ * load_direct: like load_in_memory, but the payload is read with O_DIRECT in parallel chunks, bypassing the page cache,
+ * so that a one-shot load of a huge file does not evict the pages of other processes. The payload is placed in memory
+ * like it is in the file relative to the pages, so that the reads land in place instead of going through bounce buffers.
+ * load_parallel: like load_in_memory, but the payload is read with pread calls issued in parallel on page-aligned ranges,
+ * to get the bandwidth of striped drives which a single stream cannot reach.
+ *
+ * Except for load_c_order, a Fortran-ordered payload is exposed as it is, with column-major strides.
+ */
+enum npy_array_mode
+{
+    load_in_memory,
+    map_read_only,
+    map_read_write,
+    load_c_order,
+    load_direct,
+    load_parallel
+};
+
+/**
+ * @brief Options of npy_array::save().
+ *
+ * byte_order: the byte order of the saved payload, the native one by default.
+ * direct: true to write the file with O_DIRECT in parallel chunks, bypassing the page cache,
+ * so that writing a huge file does not evict the pages of other processes. A payload in the native byte order placed in memory
+ * like in the file, like the one loaded with load_direct, is written straight from the array, any other one is copied in bounce buffers.
+ * parallel: true to write the payload with pwrite calls issued in parallel on page-aligned ranges, after the header,
+ * to get the bandwidth of striped drives which a single stream cannot reach. It is ignored when direct is true.
+ * pool: the pool issuing the writes of direct and parallel saves, npy_thread_pool::shared() when null.
+ * atomic: true to write a temporary file in the same directory and then rename it to the path, so that a failed save
+ * leaves the previous file, if any, in place instead of a truncated one. The new file keeps the permissions of the previous one,
+ * and a symbolic link at the path keeps pointing to the new file. A path that is not a regular file, like a device, is written in place.
+ * sync: true to make the file durable before returning, with fsync on the file and, for an atomic save, on its directory.
+ */
+struct npy_save_options
+{
+    npy_endianness byte_order = npy_endianness::native;
+    bool direct = false;
+    bool parallel = false;
+    npy_thread_pool* pool = nullptr;
+    bool atomic = true;
+    bool sync = false;
+};
+
+class npz_archive;
+class npy_any_array;
+
+/**
+ * @brief N-dimensional array of elements of type T, loaded from or saved to a NumPy array file.
+ *
+ * The payload owned by the array is allocated by Allocator, for instance npy_aligned_allocator or npy_huge_page_allocator,
+ * or any allocator satisfying the standard requirements. A payload referring to a mapping is never allocated.
+ *
+ * @tparam T the type of the elements.
+ * @tparam Allocator the allocator of the payload owned by the array.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
 class npy_array
 {
 public:
     typedef T value_type;
+    typedef Allocator allocator_type;
     typedef T& reference;
     typedef const T& const_reference;
     typedef size_t size_type;
     typedef T* iterator;
     typedef const T* const_iterator;
 
-    npy_array(const std::string& array_path);
+    npy_array(const std::string& array_path, npy_array_mode mode = npy_array_mode::load_in_memory, const Allocator& allocator = Allocator());
+    /**
+     * @brief Load the array file at the given path, issuing the reads of load_direct and load_parallel on the given pool
+     * instead of npy_thread_pool::shared(), so that the number of requests in flight can be tuned to the device.
+     * The transpose of load_c_order runs on the given pool too.
+     */
+    npy_array(const std::string& array_path, npy_array_mode mode, npy_thread_pool& pool, const Allocator& allocator = Allocator());
 
-    npy_array(const std::vector<size_type>& shape);
-    npy_array(std::vector<size_type>&& shape);
-    npy_array(std::initializer_list<size_type> shape_list);
+    npy_array(const std::vector<size_type>& shape, const Allocator& allocator = Allocator());
+    npy_array(std::vector<size_type>&& shape, const Allocator& allocator = Allocator());
+    npy_array(std::initializer_list<size_type> shape_list, const Allocator& allocator = Allocator());
 
     npy_array(const std::vector<size_type>& shape, const std::vector<T>& data);
     npy_array(std::vector<size_type>&& shape, std::vector<T>&& data);
     npy_array(std::initializer_list<size_type> shape_list, std::initializer_list<T> data_list);
 
+    /**
+     * @brief Create an array of the given shape whose elements are left uninitialized, unlike the shape constructors which zero them.
+     *
+     * It spares the zero-filling of the whole payload to the producers which overwrite every element anyway.
+     * Reading an element before writing it is undefined behaviour.
+     *
+     * @param shape the shape of the array.
+     * @param allocator the allocator of the payload.
+     * @return npy_array the array, owning its uninitialized payload.
+     * @throw npy_array_exception unsupported_dtype if T has no dtype, unsufficient_memory if the payload cannot be allocated.
+     */
+    static npy_array uninitialized(const std::vector<size_type>& shape, const Allocator& allocator = Allocator());
+
+    static npy_array create_mapped(const std::string& array_path, const std::vector<size_type>& shape);
+
+    /**
+     * @brief Load the array file at the given path converting its elements to T, whatever their dtype.
+     *
+     * The payload is read, byte swapped if needed, and converted one chunk at a time with vectorized kernels,
+     * so no intermediate copy of the whole payload is ever made.
+     * A file whose dtype already matches T is loaded like the path constructor does.
+     *
+     * @param array_path the path of the file.
+     * @param cast how the values out of the range of T are converted.
+     * @param allocator the allocator of the payload.
+     * @return npy_array the converted array, owning its payload.
+     * @throw npy_array_exception unsupported_dtype if the dtype of the file cannot be converted to T, or the errors of the path constructor.
+     */
+    static npy_array load_converted(const std::string& array_path, npy_cast cast = npy_cast::cast_unchecked, const Allocator& allocator = Allocator());
+
+    /**
+     * @brief Load a range of rows, the indexes of the first axis, of the array file at the given path, without reading the rest of the payload.
+     *
+     * The rows are read with pread calls issued in parallel on the pool, like load_parallel does.
+     *
+     * @param array_path the path of the file.
+     * @param first_row the index of the first row to load.
+     * @param row_count the number of rows to load.
+     * @param pool the pool issuing the reads.
+     * @param allocator the allocator of the payload.
+     * @return npy_array the array of shape (row_count, ...) holding the rows, owning its payload.
+     * @throw std::out_of_range if the range exceeds the rows of the file,
+     * npy_array_exception unsupported_layout if the file is in Fortran order or is 0-d, or the errors of npy_header::probe().
+     */
+    static npy_array load_rows(const std::string& array_path, size_type first_row, size_type row_count,
+                               npy_thread_pool& pool = npy_thread_pool::shared(), const Allocator& allocator = Allocator());
+    /**
+     * @brief Load the given rows, the indexes of the first axis, of the array file at the given path, without reading the rest of the payload.
+     *
+     * The rows are sorted and the runs of adjacent rows are coalesced, so that each run is read by a single pread call.
+     * The reads are issued in parallel on the pool, to keep many of them in flight.
+     *
+     * @param array_path the path of the file.
+     * @param rows the indexes of the rows to load, in any order, possibly repeated.
+     * @param pool the pool issuing the reads.
+     * @param allocator the allocator of the payload.
+     * @return npy_array the array of shape (rows.size(), ...) whose i-th row is the rows[i]-th row of the file, owning its payload.
+     * @throw std::out_of_range if a row exceeds the rows of the file,
+     * npy_array_exception unsupported_layout if the file is in Fortran order or is 0-d, or the errors of npy_header::probe().
+     */
+    static npy_array load_rows(const std::string& array_path, const std::vector<size_type>& rows,
+                               npy_thread_pool& pool = npy_thread_pool::shared(), const Allocator& allocator = Allocator());
+
+    /**
+     * @brief Load the array file at the given path on a pool, without blocking the calling thread.
+     *
+     * The file is loaded like the path constructor does, so the future rethrows its errors.
+     *
+     * @param array_path the path of the file.
+     * @param mode how the payload is made available to the array.
+     * @param pool the pool loading the file.
+     * @param allocator the allocator of the payload, copied into the task.
+     * @return std::future<npy_array> the future of the loaded array.
+     */
+    static std::future<npy_array> async_load(const std::string& array_path, npy_array_mode mode = npy_array_mode::load_in_memory,
+                                             npy_thread_pool& pool = npy_thread_pool::io(), const Allocator& allocator = Allocator());
+
     npy_array() = delete;
-    npy_array(const npy_array& other) = default;
-    npy_array(npy_array&& other) = default;
+    npy_array(const npy_array& other);
+    npy_array(npy_array&& other) noexcept;
 
     ~npy_array() = default;
 
-    npy_array& operator=(const npy_array& other) = default;
-    npy_array& operator=(npy_array&& other) = default;
+    npy_array& operator=(const npy_array& other);
+    npy_array& operator=(npy_array&& other) noexcept;
 
     reference operator[](size_type index) noexcept;
     const_reference operator[](size_type index) const noexcept;
@@ -61,9 +224,50 @@ public:
     reference at(std::initializer_list<size_type> indexes);
     const_reference at(std::initializer_list<size_type> indexes) const;
 
+    /**
+     * @brief The element at the given indexes, one for each dimension, without bounds checking.
+     *
+     * Unlike operator[], the indexes are not gathered in a list and the computation of the offset is unrolled on their number.
+     * The number of indexes must match the number of dimensions, which is only asserted.
+     */
+    template<typename... Indexes>
+    reference operator()(Indexes... indexes) noexcept;
+    template<typename... Indexes>
+    const_reference operator()(Indexes... indexes) const noexcept;
+
+    /**
+     * @brief The element at the given indexes, one for each dimension, like operator() but checked.
+     *
+     * A single index is the flat one of at(size_type).
+     *
+     * @throw std::out_of_range if the number of indexes does not match the number of dimensions, or if an index is out of its dimension.
+     */
+    template<typename... Indexes, typename = typename std::enable_if<sizeof...(Indexes) != 1>::type>
+    reference at(Indexes... indexes);
+    template<typename... Indexes, typename = typename std::enable_if<sizeof...(Indexes) != 1>::type>
+    const_reference at(Indexes... indexes) const;
+
+    /**
+     * @brief An accessor of the elements with the shape and the strides of the array held in fixed-size arrays, for the hot loops.
+     *
+     * The accessor refers to the payload of the array, it is invalidated by the operations replacing the payload, like to_c_order().
+     *
+     * @tparam N the number of dimensions of the array.
+     * @throw std::invalid_argument if the array does not have N dimensions.
+     */
+    template<size_t N>
+    npy_accessor<T, N> accessor();
+    template<size_t N>
+    npy_accessor<const T, N> accessor() const;
+
     const std::vector<size_type>& shape() const noexcept;
     const npy_dtype& dtype() const noexcept;
+    /**
+     * @brief A copy of the allocator of the payload.
+     */
+    Allocator get_allocator() const;
     bool fortran_order() const noexcept;
+    bool mapped() const noexcept;
 
     iterator begin() noexcept;
     const_iterator begin() const noexcept;
@@ -79,19 +283,76 @@ public:
     size_type size() const noexcept;
     size_type byte_size() const noexcept;
 
-    void save(const std::string& array_path);
+    void save(const std::string& array_path, npy_endianness byte_order = npy_endianness::native) const;
+    void save(const std::string& array_path, const npy_save_options& options) const;
+    /**
+     * @brief Save the array on a pool, without blocking the calling thread.
+     *
+     * The array is saved like save() does, it is neither copied nor locked:
+     * it must not be modified or destroyed until the returned future is ready.
+     *
+     * @param array_path the path of the file.
+     * @param byte_order the byte order of the saved payload.
+     * @param pool the pool saving the file.
+     * @return std::future<void> the future that becomes ready once the file is written.
+     */
+    std::future<void> async_save(const std::string& array_path, npy_endianness byte_order = npy_endianness::native,
+                                 npy_thread_pool& pool = npy_thread_pool::io()) const;
+    void sync(bool asynchronous = false);
+
+    /**
+     * @brief Rearrange a Fortran-ordered payload in C order, it does nothing if the array is already in C order.
+     *
+     * The payload is transposed with a cache-blocked kernel running on the given pool into memory owned by the array,
+     * so a mapped array is detached from its file.
+     *
+     * @param pool the pool running the transpose.
+     */
+    void to_c_order(npy_thread_pool& pool = npy_thread_pool::shared());
 private:
+    // std::vector<bool> is a packed bitset without data(), so the booleans are stored one per byte.
+    typedef typename std::conditional<std::is_same<T, bool>::value, uint8_t, T>::type storage_type;
+    // The payload is default-initialized, so that the buffers read from a file are not zero-filled first.
+    typedef npy_default_init_allocator<typename std::allocator_traits<Allocator>::template rebind_alloc<storage_type>> storage_allocator;
+    typedef std::vector<storage_type, storage_allocator> storage_vector;
+
     std::vector<size_type> _shape;
-    std::vector<T> _data;
+    storage_vector _data;
+    // The vector moved into the array by the data constructor, adopted as the payload instead of being copied into _data.
+    // Its elements cannot be moved into _data, whose allocator default-initializes them.
+    std::vector<storage_type> _adopted_data;
+    // The mapping backing the payload when the array has been opened with a map_* mode, null otherwise.
+    std::shared_ptr<npy_mapping> _mapping;
+    // The payload, pointing either into _data or into _mapping.
+    T* _pointer;
+    size_type _size;
     std::vector<size_type> _strides;
     npy_dtype _dtype;
     bool _fortran_order;
 
-    bool check_magic_string(std::ifstream& array_file);
-    bool check_version(std::ifstream& array_file);
-    std::string read_header(std::ifstream& array_file);
-    void parse_header(const std::string& header);
     void check_for_strides();
+    void attach_data() noexcept;
+    // Load the payload of the file whose header has already been read, the stream being positioned at the payload.
+    // The reads of load_direct and load_parallel are issued on pool, or on npy_thread_pool::shared() when it is null.
+    void load(std::ifstream& array_file, const std::string& array_path, const npy_header& header, npy_array_mode mode, npy_thread_pool* pool = nullptr);
+    // Read the header of a file whose rows are loaded, checking that they can be.
+    static npy_header probe_rows(const std::string& array_path);
+
+    // Open the array file and load it.
+    void open(const std::string& array_path, npy_array_mode mode, npy_thread_pool* pool);
+
+    npy_array(std::ifstream& array_file, const std::string& array_path, const npy_header& header, npy_array_mode mode,
+              const Allocator& allocator = Allocator());
+
+    // The allocator is kept for the copies of the array, even if the payload refers to the mapping.
+    npy_array(const std::vector<size_type>& shape, bool fortran_order, std::shared_ptr<npy_mapping> mapping, size_type payload_offset,
+              const Allocator& allocator = Allocator());
+
+    struct uninitialized_payload {};
+    npy_array(const std::vector<size_type>& shape, const Allocator& allocator, uninitialized_payload);
+
+    friend class npz_archive;
+    friend class npy_any_array;
 };
 
 #include "npy_array/npy_array.ipp"
@@ -0,0 +1,83 @@
+#ifndef B7E2C5A9_4D13_4F68_A1C7_8E3B6D2F9A05
+#define B7E2C5A9_4D13_4F68_A1C7_8E3B6D2F9A05
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "npy_array/npy_array.h"
+#include "npy_array/npy_exception.h"
+#include "npy_array/npy_header.h"
+#include "npy_array/npy_thread_pool.h"
+
+/**
+ * @brief The outcome of loading one file of a batch: either the array, or the reason why it could not be loaded.
+ */
+template<typename T>
+struct npy_batch_item
+{
+    std::unique_ptr<npy_array<T>> array; // The loaded array, null if the file could not be loaded.
+    npy_array_exception_type error; // The type of the exception raised while loading the file, meaningful only when array is null.
+};
+
+/**
+ * @brief The outcome of probing one file of a batch: either its header, or the reason why it could not be read.
+ */
+struct npy_probe_item
+{
+    npy_header header; // The header of the file, meaningful only when probed is true.
+    bool probed; // Whether the header could be read.
+    npy_array_exception_type error; // The type of the exception raised while reading the header, meaningful only when probed is false.
+};
+
+/**
+ * @brief Read the headers of many array files concurrently with npy_header::probe(), without reading their payloads.
+ *
+ * Like npy_load_batch(), the calls are latency bound, so a dedicated pool with more threads than the hardware ones
+ * can be used to keep more requests in flight. A file that cannot be probed does not stop the others.
+ *
+ * @param paths the paths of the files.
+ * @param pool the pool reading the headers.
+ * @return std::vector<npy_probe_item> one item for each path, in the same order.
+ */
+std::vector<npy_probe_item> npy_probe_batch(const std::vector<std::string>& paths, npy_thread_pool& pool = npy_thread_pool::shared());
+
+/**
+ * @brief Load many array files concurrently, one task per range of files on the given pool.
+ *
+ * Every file is loaded like the path constructor of npy_array does, so the time spent in open and read calls
+ * of different files overlaps. Loading small files is bound by the latency of these calls rather than by the CPU,
+ * so a dedicated pool with more threads than the hardware ones can be used to keep more requests in flight.
+ * A file that cannot be loaded does not stop the others, its error is reported in its item.
+ * With load_c_order, the Fortran-ordered payloads are transposed once all the files have been read.
+ *
+ * @param paths the paths of the files.
+ * @param mode how the payloads are made available to the arrays.
+ * @param pool the pool loading the files.
+ * @return std::vector<npy_batch_item<T>> one item for each path, in the same order.
+ */
+template<typename T>
+std::vector<npy_batch_item<T>> npy_load_batch(const std::vector<std::string>& paths, npy_array_mode mode = npy_array_mode::load_in_memory,
+                                              npy_thread_pool& pool = npy_thread_pool::shared());
+
+/**
+ * @brief Load many array files having the same shape concurrently, stacking them in a single array in C order.
+ *
+ * The stacked array has shape (paths.size(), shape of the files...), and the payload of every file is read directly
+ * into its slot, so no intermediate array is created. Payloads in the opposite byte order are swapped while they are read,
+ * the Fortran-ordered ones are transposed once all the files have been read.
+ *
+ * @param paths the paths of the files, at least one.
+ * @param pool the pool loading the files.
+ * @return npy_array<T> the stacked array.
+ * @throw std::invalid_argument if paths is empty.
+ * @throw npy_array_exception unmatched_shape_data if the files do not share the same shape,
+ * or the first error, in the order of the paths, that prevented loading a file.
+ */
+template<typename T>
+npy_array<T> npy_load_stacked(const std::vector<std::string>& paths, npy_thread_pool& pool = npy_thread_pool::shared());
+
+#include "npy_array/npy_batch.ipp"
+
+#endif /* B7E2C5A9_4D13_4F68_A1C7_8E3B6D2F9A05 */
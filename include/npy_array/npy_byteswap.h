@@ -0,0 +1,32 @@
+#ifndef F2B86D14_5E7A_4C39_9D0B_3A6E8C1F5D72
+#define F2B86D14_5E7A_4C39_9D0B_3A6E8C1F5D72
+
+#include <cstddef>
+
+#include "npy_array/endianess.h"
+#include "npy_array/npy_dtype.h"
+
+/**
+ * @brief Reverse the byte order of count consecutive units of unit_size bytes, in place.
+ *
+ * The supported unit sizes are 1, 2, 4, 8, and 16 bytes, a unit size of 1 leaves the data untouched.
+ * The swap is vectorized with AVX2 or SSSE3 shuffles when the target supports them.
+ *
+ * @param data the first byte of the data to swap.
+ * @param count the number of units to swap.
+ * @param unit_size the size in bytes of a unit.
+ */
+void npy_byteswap(void* data, size_t count, size_t unit_size) noexcept;
+
+/**
+ * @brief Reverse the byte order of count consecutive elements having the given dtype, in place.
+ *
+ * The real and the imaginary parts of a complex dtype are swapped independently.
+ *
+ * @param data the first element to swap.
+ * @param count the number of elements to swap.
+ * @param dtype the dtype of the elements.
+ */
+void npy_byteswap(void* data, size_t count, const npy_dtype& dtype) noexcept;
+
+#endif /* F2B86D14_5E7A_4C39_9D0B_3A6E8C1F5D72 */
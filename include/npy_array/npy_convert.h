@@ -0,0 +1,67 @@
+#ifndef C9E4A2D7_3B85_4F16_9D0A_6E2C8B1F5A43
+#define C9E4A2D7_3B85_4F16_9D0A_6E2C8B1F5A43
+
+#include <cstddef>
+#include <complex>
+#include <limits>
+#include <type_traits>
+#include <stdint.h>
+
+#include "npy_array/npy_dtype.h"
+#include "npy_array/npy_exception.h"
+
+/**
+ * @brief How the values that do not fit the destination type are converted.
+ *
+ * cast_unchecked: the values are converted like static_cast does, so integers wrap around like numpy.astype(),
+ * and the conversion of a floating point value outside the range of an integer type is undefined.
+ * cast_saturate: the values are clamped to the range of the destination type, NaN is converted to 0 by integer types,
+ * and finite floating point values never overflow to infinity.
+ */
+enum npy_cast
+{
+    cast_unchecked,
+    cast_saturate
+};
+
+/**
+ * @brief Convert IEEE 754 half precision values, given as their bits, to float.
+ *
+ * It uses the F16C instructions when available, the conversion is exact.
+ */
+void npy_half_to_float(const uint16_t* source, float* destination, size_t count) noexcept;
+
+/**
+ * @brief Convert double values to float, rounding to nearest.
+ *
+ * It uses the AVX instructions when available.
+ *
+ * @param saturate true to clamp the finite values to the float range instead of overflowing to infinity.
+ */
+void npy_double_to_float(const double* source, float* destination, size_t count, bool saturate) noexcept;
+
+/**
+ * @brief Convert count elements having the given dtype, in native byte order, to T.
+ *
+ * Every supported dtype, float_16 included, is converted to every supported T.
+ * A complex dtype can only be converted to a complex T, a boolean T is true for every non zero value.
+ *
+ * @param source the elements to convert, in native byte order.
+ * @param source_dtype the dtype of the source elements, its byte order is ignored.
+ * @param destination where the count converted elements are written.
+ * @param count the number of elements.
+ * @param cast how the values out of the range of T are converted.
+ * @throw npy_array_exception unsupported_dtype if the source dtype cannot be converted to T.
+ */
+template<typename T>
+void npy_convert(const void* source, const npy_dtype& source_dtype, T* destination, size_t count, npy_cast cast);
+
+/**
+ * @brief Whether the elements of the given dtype can be converted to T.
+ */
+template<typename T>
+bool npy_convertible(const npy_dtype& source_dtype) noexcept;
+
+#include "npy_array/npy_convert.ipp"
+
+#endif /* C9E4A2D7_3B85_4F16_9D0A_6E2C8B1F5A43 */
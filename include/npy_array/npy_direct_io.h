@@ -0,0 +1,189 @@
+#ifndef A6D3F8B1_7C24_4E95_B2A8_5F1E9C3D7B46
+#define A6D3F8B1_7C24_4E95_B2A8_5F1E9C3D7B46
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "npy_array/npy_exception.h"
+#include "npy_array/npy_thread_pool.h"
+
+/**
+ * @brief The alignment in bytes of the file offsets, lengths, and memory buffers of the direct I/O requests.
+ */
+const size_t npy_direct_alignment = 4096;
+
+/**
+ * @brief The default size in bytes of the chunks in which a direct I/O transfer is split.
+ */
+const size_t npy_direct_chunk_size = 8 << 20;
+
+/**
+ * @brief Read length bytes at the given offset of a file with O_DIRECT, bypassing the page cache.
+ *
+ * The range is widened to npy_direct_alignment and split in chunks of chunk_size bytes, read in parallel on the pool.
+ * When destination is placed in memory like offset is in the file, relative to npy_direct_alignment, the whole pages
+ * of the range are read straight into destination. The partial pages at the ends of the range, every page of a destination
+ * placed otherwise, and the pages whose direct read is refused with EINVAL, are read into an aligned bounce buffer and then copied,
+ * so neither offset nor destination need to be aligned.
+ * If the file system does not support O_DIRECT, the file is read through the page cache and then the range is dropped from it.
+ *
+ * @param path the path of the file.
+ * @param offset the offset in bytes of the first byte to read.
+ * @param destination where the length bytes read are written.
+ * @param length the number of bytes to read.
+ * @param pool the pool issuing the reads.
+ * @param chunk_size the size in bytes of the reads, rounded up to npy_direct_alignment.
+ * @throw npy_array_exception input_output_error if the file cannot be read or it is shorter than offset + length,
+ * unsufficient_memory if the bounce buffers cannot be allocated.
+ */
+void npy_direct_read(const std::string& path, uint64_t offset, char* destination, size_t length,
+                     npy_thread_pool& pool, size_t chunk_size = npy_direct_chunk_size);
+
+/**
+ * @brief Create a file of length bytes with O_DIRECT, bypassing the page cache, truncating an existing file.
+ *
+ * The file is split in chunks of chunk_size bytes written in parallel on the pool.
+ * If source holds the bytes of the file from source_offset on, and is placed in memory like source_offset is in the file,
+ * relative to npy_direct_alignment, the whole pages it holds are written straight from it.
+ * The content of the other pages, and of the pages whose direct write is refused with EINVAL, is produced by
+ * fill(offset, buffer, count) into an aligned bounce buffer, where offset is the offset of the range in the file and count its size,
+ * so fill is called concurrently on disjoint ranges.
+ * The last page is padded to npy_direct_alignment and the file is then truncated to its length.
+ * If the file system does not support O_DIRECT, the file is written through the page cache, flushed, and then dropped from it.
+ *
+ * @param path the path of the file.
+ * @param length the size in bytes of the file.
+ * @param fill the callable producing the content of the chunks.
+ * @param pool the pool issuing the writes.
+ * @param chunk_size the size in bytes of the writes, rounded up to npy_direct_alignment.
+ * @param source the bytes of the file from source_offset to length, or null if fill produces every byte.
+ * @param source_offset the offset in the file of the first byte of source.
+ * @throw npy_array_exception input_output_error if the file cannot be written, unsufficient_memory if the bounce buffers cannot be allocated.
+ */
+void npy_direct_write(const std::string& path, uint64_t length, const std::function<void(uint64_t, char*, size_t)>& fill,
+                      npy_thread_pool& pool, size_t chunk_size = npy_direct_chunk_size, const char* source = nullptr, uint64_t source_offset = 0);
+
+/**
+ * @brief The default size in bytes of the ranges in which a parallel positional I/O transfer is split.
+ */
+const size_t npy_parallel_chunk_size = 4 << 20;
+
+/**
+ * @brief Read length bytes at the given offset of a file with pread calls issued in parallel, through the page cache.
+ *
+ * The range is split at the file offsets multiple of chunk_size, so that every read but the first and the last one
+ * covers whole pages and whole stripes of the device, and the reads are spread on the threads of the pool:
+ * a striped array of drives only delivers its bandwidth with many requests in flight.
+ * If transform is not empty, it is called on every range right after reading it, while it is still in cache,
+ * concurrently on disjoint ranges; the ranges start at offsets multiple of 64 from offset when offset is.
+ *
+ * @param path the path of the file.
+ * @param offset the offset in bytes of the first byte to read.
+ * @param destination where the length bytes read are written.
+ * @param length the number of bytes to read.
+ * @param pool the pool issuing the reads.
+ * @param chunk_size the size in bytes of the reads, rounded up to npy_direct_alignment.
+ * @param transform the callable transforming the bytes read, like a byte swap.
+ * @throw npy_array_exception input_output_error if the file cannot be read or it is shorter than offset + length.
+ */
+void npy_parallel_read(const std::string& path, uint64_t offset, char* destination, size_t length,
+                       npy_thread_pool& pool, size_t chunk_size = npy_parallel_chunk_size,
+                       const std::function<void(char*, size_t)>& transform = nullptr);
+
+/**
+ * @brief Create a file made of a preamble followed by a payload, writing the payload with pwrite calls issued in parallel.
+ *
+ * The preamble is written once, then the payload is split at the file offsets multiple of chunk_size and the ranges
+ * are written on the threads of the pool, like npy_parallel_read() does. An existing file is truncated.
+ * If transform is not empty, every range is copied into a buffer and transformed there before being written,
+ * concurrently on disjoint ranges, so that payload is left untouched.
+ *
+ * @param path the path of the file.
+ * @param preamble the bytes written at the beginning of the file.
+ * @param payload the bytes written after the preamble.
+ * @param length the number of bytes of the payload.
+ * @param pool the pool issuing the writes.
+ * @param chunk_size the size in bytes of the writes, rounded up to npy_direct_alignment.
+ * @param transform the callable transforming the bytes written, like a byte swap.
+ * @throw npy_array_exception input_output_error if the file cannot be written, unsufficient_memory if the buffers cannot be allocated.
+ */
+void npy_parallel_write(const std::string& path, const std::string& preamble, const char* payload, size_t length,
+                        npy_thread_pool& pool, size_t chunk_size = npy_parallel_chunk_size,
+                        const std::function<void(char*, size_t)>& transform = nullptr);
+
+/**
+ * @brief A range of a file to read into memory.
+ */
+struct npy_read_request
+{
+    uint64_t offset; // The offset in bytes of the range in the file.
+    size_t length; // The size in bytes of the range.
+    char* destination; // Where the range is written.
+};
+
+/**
+ * @brief Read many ranges of a file, one pread call for each, issued in parallel on the pool.
+ *
+ * The reads of scattered ranges are bound by the latency of the device, so keeping many of them in flight
+ * with a pool of many threads multiplies their throughput.
+ *
+ * @param path the path of the file.
+ * @param requests the ranges to read, their destinations must not overlap.
+ * @param pool the pool issuing the reads.
+ * @throw npy_array_exception input_output_error if the file cannot be read or a range ends past the end of the file.
+ */
+void npy_gather_read(const std::string& path, const std::vector<npy_read_request>& requests, npy_thread_pool& pool);
+
+/**
+ * @brief Create a file made of a preamble followed by a payload, truncating an existing file.
+ *
+ * Both are written by a single writev call, retried only on short writes.
+ * If transform is not empty, the payload is copied chunk by chunk into a buffer and transformed there before being written,
+ * so that payload is left untouched; the chunks start at offsets multiple of 64 from payload.
+ *
+ * @param path the path of the file.
+ * @param preamble the bytes written at the beginning of the file.
+ * @param preamble_size the number of bytes of the preamble.
+ * @param payload the bytes written after the preamble.
+ * @param length the number of bytes of the payload.
+ * @param transform the callable transforming the bytes written, like a byte swap.
+ * @throw npy_array_exception input_output_error if the file cannot be written.
+ */
+void npy_write_file(const std::string& path, const char* preamble, size_t preamble_size, const char* payload, size_t length,
+                    const std::function<void(char*, size_t)>& transform = nullptr);
+
+/**
+ * @brief The path where a file replacing the one at the given path is moved by npy_commit_file().
+ *
+ * It is the path itself, unless it is a symbolic link: then it is the resolved path of the regular file the link points to,
+ * so that the link is kept and points to the new file.
+ *
+ * @param path the path of the file to replace.
+ * @return std::string the path to replace, or an empty string if the path, or the target of the link, exists
+ * but is not a regular file, like a device, or cannot be resolved: such a file can only be written in place.
+ */
+std::string npy_commit_path(const std::string& path);
+
+/**
+ * @brief A path in the directory of the given one, not used by any other thread or process, where a file can be written
+ * before being moved to path by npy_commit_file().
+ */
+std::string npy_temporary_path(const std::string& path);
+
+/**
+ * @brief Move the file written at temporary_path to path, atomically replacing an existing file.
+ *
+ * Readers of path see either the previous file or the whole new one, never a truncated file.
+ * The new file gets the permissions of the file it replaces. If temporary_path is path, the file is left where it is.
+ *
+ * @param temporary_path the path where the file has been written.
+ * @param path the final path of the file.
+ * @param sync true to make the file and its name durable before returning, with fsync on the file and on its directory.
+ * @throw npy_array_exception input_output_error if the file cannot be synchronized or renamed.
+ */
+void npy_commit_file(const std::string& temporary_path, const std::string& path, bool sync);
+
+#endif /* A6D3F8B1_7C24_4E95_B2A8_5F1E9C3D7B46 */
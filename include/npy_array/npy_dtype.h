@@ -4,8 +4,8 @@
 #include <cstddef>
 #include <type_traits>
 #include <complex>
-
-#include <boost/regex.hpp>
+#include <string>
+#include <stdint.h>
 
 #include "npy_array/endianess.h"
 #include "npy_array/npy_exception.h"
@@ -29,6 +29,22 @@ enum npy_dtype_kind
     unkwown = '!' // artificial kind used for the null dtype.
 };
 
+/**
+ * @brief Fixed capacity string holding a dtype string format, such as "<f8" or "|b1".
+ *
+ * It is built without allocating memory, also in constant expressions.
+ * The characters are null terminated.
+ */
+struct npy_dtype_string
+{
+    char characters[5]; // The longest dtype string has 4 characters, as "<c16", plus the terminator.
+    size_t length; // The number of characters, the terminator excluded.
+
+    constexpr const char* c_str() const noexcept {return characters;}
+    constexpr size_t size() const noexcept {return length;}
+    std::string str() const {return std::string{characters, length};}
+};
+
 /**
  * @brief Class that expresses a NumPy dtype object.
  * 
@@ -61,6 +77,7 @@ enum npy_dtype_kind
  * uint_16, unsigned 16-bit integer value backed by C++ uint16_t and unsigned short.
  * uint_32, unsigned 32-bit integer value backed by C++ uint32_t and unsigned int.
  * uint_64, unsigned 64-bit integer value backed by C++ uint64_t and unsigned long.
+ * float_16, 16-bit IEEE 754 half precision floating point value, not backed by any C++ type: it can only be loaded with a conversion.
  * float_32, 32-bit floating point value backed by C++ float.
  * float_64, 64-bit floating point value backed by C++ double.
  * float_128, 128-bit floating point value backed by C++ long double.
@@ -68,6 +85,8 @@ enum npy_dtype_kind
  * complex_128, 128-bit complex value backed by C++ std::complex<double>.
  * complex_256, 256-bit complex value backed by C++ std::complex<long double>.
  * 
+ * Every method but str() is constexpr, so the dtypes can be built and compared in constant expressions.
+ *
  * The whole object does not throw exceptions, but when errors occur (during the creation of an object) the null dtype is returned.
  * If the user builds its own dtype, either by providing a type or a dtype string, it must check if the retrieved dtype is not equal to the null dtype.
  * A null dtype has the following invariants:
@@ -86,7 +105,7 @@ public:
      * item size = 0
      * byte order = npy_endianess::not_applicable.>
      */
-    npy_dtype() noexcept;
+    constexpr npy_dtype() noexcept;
 
     /**
      * @brief Copy constructor, construct a dtype object given another one.
@@ -95,7 +114,7 @@ public:
      * 
      * @param other another dtype object.
      */
-    npy_dtype(const npy_dtype& other) = default;
+    constexpr npy_dtype(const npy_dtype& other) = default;
     /**
      * @brief Move constructor, construct a new dtype object by moving another one.
      * 
@@ -103,7 +122,7 @@ public:
      * 
      * @param other another dtype object.
      */
-    npy_dtype(npy_dtype&& other);
+    constexpr npy_dtype(npy_dtype&& other) noexcept;
 
     /**
      * @brief Destroy the npy_dtype object
@@ -121,7 +140,7 @@ public:
      * @param other the dtype object to copy.
      * @return npy_dtype& this object.
      */
-    npy_dtype& operator=(const npy_dtype& other) = default;
+    constexpr npy_dtype& operator=(const npy_dtype& other) = default;
     /**
      * @brief Move assignment, move the given dtype object to this.
      * 
@@ -130,13 +149,13 @@ public:
      * @param other the dtype object to move.
      * @return npy_dtype& this object.
      */
-    npy_dtype& operator=(npy_dtype&& other);
+    constexpr npy_dtype& operator=(npy_dtype&& other) noexcept;
 
 
-    explicit operator bool() const noexcept;
+    constexpr explicit operator bool() const noexcept;
 
-    bool operator==(const npy_dtype& other) const noexcept;
-    bool operator!=(const npy_dtype& other) const noexcept;
+    constexpr bool operator==(const npy_dtype& other) const noexcept;
+    constexpr bool operator!=(const npy_dtype& other) const noexcept;
 
     /**
      * @brief The kind of this dtype object.
@@ -146,7 +165,7 @@ public:
      * 
      * @return npy_dtype_kind the kind of this dtype object.
      */
-    npy_dtype_kind kind() const;
+    constexpr npy_dtype_kind kind() const noexcept;
     /**
      * @brief The size in bytes taken by an element having this dtype.
      * 
@@ -155,7 +174,7 @@ public:
      * 
      * @return size_t the size in bytes.
      */
-    size_t item_size() const;
+    constexpr size_t item_size() const noexcept;
     /**
      * @brief The byte order, or endianess, of this dtype when the item size is >= 2.
      * 
@@ -165,7 +184,7 @@ public:
      * 
      * @return npy_endianness the byte order of the dtype.
      */
-    npy_endianness byte_order() const;
+    constexpr npy_endianness byte_order() const noexcept;
     /**
      * @brief The string represention of a dtype object according to NumPy dtype string format.
      * 
@@ -175,9 +194,27 @@ public:
      * The last character or the last two characters are the string version of the item size which can take
      * 1 character for sizes 1, 2, 4, 8, and two characters for the size 16.
      * 
+     * The string is built from descr(), it is short enough to never allocate memory.
+     *
      * @return std::string the string representation of a dtype object.
      */
     std::string str() const;
+    /**
+     * @brief The string represention of a dtype object as str(), held by a fixed capacity string.
+     * 
+     * @return npy_dtype_string the string representation of a dtype object.
+     */
+    constexpr npy_dtype_string descr() const noexcept;
+    /**
+     * @brief The same dtype with the given byte order.
+     * 
+     * The native byte order is resolved to the machine endianess.
+     * The byte order of a dtype with item size 1 and of the null dtype is not applicable, so they are returned unchanged.
+     * 
+     * @param byte_order the requested byte order: little endian, big endian, or native.
+     * @return npy_dtype the dtype having the requested byte order.
+     */
+    constexpr npy_dtype with_byte_order(npy_endianness byte_order) const noexcept;
 
     /**
      * @brief Return an implemented dtype given the type provided by the user.
@@ -204,7 +241,7 @@ public:
      * @tparam T The C++ type the user want to describe as ndtype.
      * @return npy_dtype The corresponding dtype of null dtype if the C++ type is not implemented or accepted.
      */
-    template<typename T> static npy_dtype from_type() noexcept
+    template<typename T> static constexpr npy_dtype from_type() noexcept
     {
         // Check if the user provided type is one of the implemented ones.
         // If yes, then return the dtype, otherwise return the null dtype.
@@ -251,7 +288,7 @@ public:
      * If both endianess and item size are omitted, then it is assumed to be uint64_t.
      * 
      * Floating Points
-     * The only allowed combinations are "[<>=]?f[4,8,16]?"
+     * The only allowed combinations are "[<>=]?f[2,4,8,16]?"
      * If both endianess and item size are omitted, then it is assumed to be double.
      * 
      * Complex
@@ -264,97 +301,128 @@ public:
      * @return npy_dtype the dtype object for the dtype string, null if the string is wrong.
      */
     static npy_dtype from_string(const std::string& dtype_string) noexcept;
+    /**
+     * @brief Given a dtype string representation of length characters, return the correspoding dtype object.
+     * 
+     * It accepts the same strings of from_string(const std::string&) and it can be used in constant expressions.
+     * 
+     * @param dtype_string the dtype string representation, it does not need to be null terminated.
+     * @param length the number of characters of the dtype string.
+     * @return npy_dtype the dtype object for the dtype string, null if the string is wrong.
+     */
+    static constexpr npy_dtype from_string(const char* dtype_string, size_t length) noexcept;
+    /**
+     * @brief Given a dtype string literal, return the correspoding dtype object.
+     * 
+     * It accepts the same strings of from_string(const std::string&) and it can be used in constant expressions,
+     * as in static_assert(npy_dtype::from_string("<f8") == npy_dtype::float_64(), "").
+     * 
+     * @param dtype_string the dtype string representation, it ends at the first null character.
+     * @return npy_dtype the dtype object for the dtype string, null if the string is wrong.
+     */
+    template<size_t N> static constexpr npy_dtype from_string(const char (&dtype_string)[N]) noexcept
+    {
+        size_t length = 0;
+        while(length < N && dtype_string[length] != '\0') length++;
+        return from_string(static_cast<const char*>(dtype_string), length);
+    }
 
     /**
      * @brief Return a 8-bit boolean value, equivalent to a bool C++ type.
      * 
      * @return npy_dtype boolean dtype.
      */
-    static npy_dtype bool_8() noexcept;
+    static constexpr npy_dtype bool_8() noexcept;
     /**
      * @brief Return a 8-bit signed integer value, equivalent to a char and int8_t C++ type.
      * 
      * @return npy_dtype 8-bit int dtype.
      */
-    static npy_dtype int_8() noexcept;
+    static constexpr npy_dtype int_8() noexcept;
     /**
      * @brief Return a 16-bit signed integer value, equivalent to a shprt and int16_t C++ type.
      * 
      * @return npy_dtype 16-bit int dtype.
      */
-    static npy_dtype int_16() noexcept;
+    static constexpr npy_dtype int_16() noexcept;
     /**
      * @brief Return a 32-bit signed integer value, equivalent to a int and int32_t C++ type.
      * 
      * @return npy_dtype 32-bit int dtype.
      */
-    static npy_dtype int_32() noexcept;
+    static constexpr npy_dtype int_32() noexcept;
     /**
      * @brief Return a 64-bit signed integer value, equivalent to a long and int64_t C++ type.
      * 
      * @return npy_dtype 64-bit int dtype.
      */
-    static npy_dtype int_64() noexcept;
+    static constexpr npy_dtype int_64() noexcept;
     /**
      * @brief Return a 8-bit unsigned integer value, equivalent to a unsigned char and uint8_t C++ type.
      * 
      * @return npy_dtype 8-bit unsigned int dtype.
      */
-    static npy_dtype uint_8() noexcept;
+    static constexpr npy_dtype uint_8() noexcept;
     /**
      * @brief Return a 16-bit unsigned integer value, equivalent to a unsigned short and uint16_t C++ type.
      * 
      * @return npy_dtype 16-bit unsigned int dtype.
      */
-    static npy_dtype uint_16() noexcept;
+    static constexpr npy_dtype uint_16() noexcept;
     /**
      * @brief Return a 32-bit unsigned integer value, equivalent to a unsigned int and uint32_t C++ type.
      * 
      * @return npy_dtype 32-bit unsigned int dtype.
      */
-    static npy_dtype uint_32() noexcept;
+    static constexpr npy_dtype uint_32() noexcept;
     /**
      * @brief Return a 64-bit unsigned integer value, equivalent to a unsigned long and uint64_t C++ type.
      * 
      * @return npy_dtype 64-bit unsigned int dtype.
      */
-    static npy_dtype uint_64() noexcept;
+    static constexpr npy_dtype uint_64() noexcept;
+    /**
+     * @brief Return a 16-bit half precision floating value, which has no equivalent C++ type.
+     * 
+     * @return npy_dtype 16-bit floating value dtype.
+     */
+    static constexpr npy_dtype float_16() noexcept;
     /**
      * @brief Return a 32-bit floating value, equivalent to a float C++ type.
      * 
      * @return npy_dtype 32-bit floating value dtype.
      */
-    static npy_dtype float_32() noexcept;
+    static constexpr npy_dtype float_32() noexcept;
     /**
      * @brief Return a 64-bit floating value, equivalent to a double C++ type.
      * 
      * @return npy_dtype 64-bit floating value dtype.
      */
-    static npy_dtype float_64() noexcept;
+    static constexpr npy_dtype float_64() noexcept;
     /**
      * @brief Return a 128-bit floating value, equivalent to a long double C++ type.
      * 
      * @return npy_dtype 128-bit floating value dtype.
      */
-    static npy_dtype float_128() noexcept;
+    static constexpr npy_dtype float_128() noexcept;
     /**
      * @brief Return a 64-bit complex, equivalent to a std::complex<float> C++ type.
      * 
      * @return npy_dtype 64-bit complex dtype.
      */
-    static npy_dtype complex_64() noexcept;
+    static constexpr npy_dtype complex_64() noexcept;
     /**
      * @brief Return a 128-bit complex, equivalent to a std::complex<double> C++ type.
      * 
      * @return npy_dtype 128-bit complex dtype.
      */
-    static npy_dtype complex_128() noexcept;
+    static constexpr npy_dtype complex_128() noexcept;
     /**
      * @brief Return a 256-bit complex, equivalent to a std::complex<long double> C++ type.
      * 
      * @return npy_dtype 256-bit complex dtype.
      */
-    static npy_dtype complex_256() noexcept;    
+    static constexpr npy_dtype complex_256() noexcept;    
     /**
      * @brief Return a null dtype.
      * 
@@ -365,7 +433,7 @@ public:
      * 
      * @return npy_dtype null dtype.
      */
-    static npy_dtype null() noexcept;
+    static constexpr npy_dtype null() noexcept;
     
 private:
     /**
@@ -377,13 +445,51 @@ private:
      * @param item_size dtype size in bytes.
      * @param byte_order the endianess of the dtype.
      */
-    npy_dtype(npy_dtype_kind kind, size_t item_size, npy_endianness byte_order=get_endianess()) noexcept;
+    constexpr npy_dtype(npy_dtype_kind kind, size_t item_size, npy_endianness byte_order=get_endianess()) noexcept;
 
     npy_dtype_kind _kind; // The private dtype's kind.
     size_t _item_size; // The private item size in bytes.
     npy_endianness _byte_order; // The private dtype's byte order.
 };
 
+#include "npy_array/npy_dtype.ipp"
+
+/**
+ * @brief Call function with a null pointer to the C++ type backing the given dtype, regardless of its byte order.
+ * 
+ * It turns a dtype known only at runtime into a type parameter, for instance through a generic lambda:
+ * npy_dtype_dispatch(dtype, [](auto* tag){using T = std::remove_pointer_t<decltype(tag)>; ...});
+ * The 8-bit signed integer dtype is dispatched as int8_t.
+ * Every instantiation of function must have the same return type.
+ * 
+ * @param dtype the dtype to dispatch.
+ * @param function the callable invoked as function(static_cast<T*>(nullptr)).
+ * @return the value returned by function.
+ * @throw npy_array_exception unsupported_dtype if the dtype is the null dtype.
+ */
+template<typename Function>
+auto npy_dtype_dispatch(const npy_dtype& dtype, Function&& function) -> decltype(function(static_cast<bool*>(nullptr)))
+{
+    npy_dtype native_dtype = dtype.with_byte_order(npy_endianness::native);
+
+    if(native_dtype == npy_dtype::bool_8()) return function(static_cast<bool*>(nullptr));
+    else if(native_dtype == npy_dtype::int_8()) return function(static_cast<int8_t*>(nullptr));
+    else if(native_dtype == npy_dtype::int_16()) return function(static_cast<int16_t*>(nullptr));
+    else if(native_dtype == npy_dtype::int_32()) return function(static_cast<int32_t*>(nullptr));
+    else if(native_dtype == npy_dtype::int_64()) return function(static_cast<int64_t*>(nullptr));
+    else if(native_dtype == npy_dtype::uint_8()) return function(static_cast<uint8_t*>(nullptr));
+    else if(native_dtype == npy_dtype::uint_16()) return function(static_cast<uint16_t*>(nullptr));
+    else if(native_dtype == npy_dtype::uint_32()) return function(static_cast<uint32_t*>(nullptr));
+    else if(native_dtype == npy_dtype::uint_64()) return function(static_cast<uint64_t*>(nullptr));
+    else if(native_dtype == npy_dtype::float_32()) return function(static_cast<float*>(nullptr));
+    else if(native_dtype == npy_dtype::float_64()) return function(static_cast<double*>(nullptr));
+    else if(native_dtype == npy_dtype::float_128()) return function(static_cast<long double*>(nullptr));
+    else if(native_dtype == npy_dtype::complex_64()) return function(static_cast<std::complex<float>*>(nullptr));
+    else if(native_dtype == npy_dtype::complex_128()) return function(static_cast<std::complex<double>*>(nullptr));
+    else if(native_dtype == npy_dtype::complex_256()) return function(static_cast<std::complex<long double>*>(nullptr));
+    else throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+}
+
 
 
 #endif /* D4AB99B8_10DA_46D7_9CFA_559B460F6ABA */
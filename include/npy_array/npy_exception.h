@@ -12,6 +12,8 @@ enum npy_array_exception_type
     unsufficient_memory,
     unsupported_dtype,
     unmatched_shape_data,
+    unsupported_layout,
+    invalid_archive,
     generic
 };
 
@@ -0,0 +1,140 @@
+#ifndef C3A9F1E4_7B62_4E8D_A0D5_5E9B1C4F7A28
+#define C3A9F1E4_7B62_4E8D_A0D5_5E9B1C4F7A28
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "npy_array/npy_dtype.h"
+#include "npy_array/npy_exception.h"
+
+/**
+ * @brief Class that describes the header of a NumPy array file, independently from the C++ type of its elements.
+ *
+ * A NumPy array file starts with a preamble made of:
+ * the magic string '\x93NUMPY',
+ * the major and minor version of the file format,
+ * the header length, 2 bytes for version 1.0 and 4 bytes for versions 2.0 and 3.0,
+ * the header, a Python dictionary literal with the keys 'descr', 'fortran_order', and 'shape',
+ * padded with spaces and terminated by a '\n' so that the whole preamble is divisible by 64.
+ * The payload of the array follows immediately the preamble.
+ *
+ * A npy_header is either read from a stream with npy_header::read(), or built from a dtype, an order and a shape
+ * in order to be written with str().
+ * Errors are reported as npy_array_exception.
+ */
+class npy_header
+{
+public:
+    typedef size_t size_type;
+
+    /**
+     * @brief Construct an empty header, having the null dtype and no dimensions.
+     */
+    npy_header() noexcept;
+    /**
+     * @brief Construct the header of an array having the given dtype, order, and shape.
+     *
+     * The version of the file format is the smallest one that fits the header.
+     *
+     * @param dtype the dtype of the elements.
+     * @param fortran_order true if the payload is stored in Fortran order.
+     * @param shape the shape of the array.
+     */
+    npy_header(const npy_dtype& dtype, bool fortran_order, const std::vector<size_type>& shape);
+
+    /**
+     * @brief Read the preamble of a NumPy array file, leaving the stream positioned at the first byte of the payload.
+     *
+     * @param array_stream the stream to read from, positioned at the beginning of the file.
+     * @return npy_header the header read.
+     * @throw npy_array_exception invalid_magic_string, unsupported_version, ill_formed_header, or input_output_error.
+     */
+    static npy_header read(std::istream& array_stream);
+    /**
+     * @brief Read the preamble of the NumPy array file at the given path, without reading its payload.
+     *
+     * The shape, dtype, order, version and payload offset of a file are known from its first few hundred bytes,
+     * read by a single pread call in most cases, whatever the size of the payload.
+     *
+     * @param array_path the path of the file.
+     * @return npy_header the header read.
+     * @throw npy_array_exception invalid_magic_string, unsupported_version, ill_formed_header, or input_output_error.
+     */
+    static npy_header probe(const std::string& array_path);
+    /**
+     * @brief Parse the header dictionary of a NumPy array file, without the preamble that precedes it.
+     *
+     * The dictionary is a Python literal: the keys can be in any order, quoted with single or double quotes,
+     * and surrounded by any whitespace, the shape can be a 0-d "()" or a 1-tuple "(5,)" and its sizes can have the Python 2 'L' suffix.
+     * It is parsed in a single pass and no memory is allocated but the shape.
+     * The returned header has version 1.0 and a header length equal to length.
+     *
+     * @param dictionary the characters of the dictionary, padding and terminating '\n' included, it does not need to be null terminated.
+     * @param length the number of characters of the dictionary.
+     * @return npy_header the header parsed.
+     * @throw npy_array_exception ill_formed_header if the dictionary is malformed, misses a key, or has an unknown key or dtype,
+     * or has a shape whose number of elements or of bytes does not fit in a size_t.
+     */
+    static npy_header from_dictionary(const char* dictionary, size_type length);
+
+    /**
+     * @brief The preamble of the file, ready to be written before the payload.
+     *
+     * The header is padded with spaces so that the preamble is at least minimum_size bytes long.
+     * This allows to rewrite in place the preamble of a file once the shape is known, as long as it fits.
+     *
+     * @param minimum_size the minimum size in bytes of the preamble.
+     * @return std::string the preamble bytes.
+     */
+    std::string str(size_type minimum_size = 0) const;
+    /**
+     * @brief Write the preamble of the file into a buffer, like str() but without allocating memory.
+     *
+     * @param buffer where the preamble is written.
+     * @param capacity the size in bytes of buffer.
+     * @param minimum_size the minimum size in bytes of the preamble.
+     * @return size_type the size in bytes of the preamble, nothing is written when it is greater than capacity.
+     */
+    size_type write_preamble(char* buffer, size_type capacity, size_type minimum_size = 0) const noexcept;
+
+    const npy_dtype& dtype() const noexcept;
+    bool fortran_order() const noexcept;
+    const std::vector<size_type>& shape() const noexcept;
+
+    /**
+     * @brief The major version of the file format, 1, 2, or 3.
+     */
+    uint8_t major_version() const noexcept;
+    /**
+     * @brief The length in bytes of the header dictionary, padding and terminating '\n' included.
+     */
+    size_type header_length() const noexcept;
+    /**
+     * @brief The offset in bytes of the payload from the beginning of the file, that is the size of the preamble.
+     */
+    size_type payload_offset() const noexcept;
+    /**
+     * @brief The number of elements of the array.
+     */
+    size_type size() const noexcept;
+    /**
+     * @brief The size in bytes of the payload.
+     */
+    size_type byte_size() const noexcept;
+
+private:
+    void parse(const char* dictionary, size_type length);
+    // Write the dictionary into buffer if it fits in capacity, return its length anyway.
+    size_type format_dictionary(char* buffer, size_type capacity) const noexcept;
+
+    npy_dtype _dtype;
+    bool _fortran_order;
+    std::vector<size_type> _shape;
+    uint8_t _major_version;
+    size_type _header_length;
+};
+
+#endif /* C3A9F1E4_7B62_4E8D_A0D5_5E9B1C4F7A28 */
@@ -0,0 +1,91 @@
+#ifndef B6E1C7A2_3F58_4D0B_9C61_7A4E2D9F0B13
+#define B6E1C7A2_3F58_4D0B_9C61_7A4E2D9F0B13
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "npy_array/npy_exception.h"
+
+/**
+ * @brief RAII wrapper around a memory mapping of a whole file.
+ *
+ * The file is mapped with MAP_SHARED, so several processes mapping the same file share the same page cache pages
+ * instead of holding private heap copies of the payload.
+ * A read-only mapping is created with PROT_READ only: writing through it raises a segmentation fault.
+ *
+ * A npy_mapping object is not copyable nor movable, it is meant to be shared through a std::shared_ptr
+ * by all the arrays that reference it.
+ * Errors while opening or mapping the file are reported as npy_array_exception with type input_output_error.
+ */
+class npy_mapping
+{
+public:
+    /**
+     * @brief Map the whole file at the given path.
+     *
+     * @param path the path of the file to map.
+     * @param writable true to map the file in read-write mode, false to map it in read-only mode.
+     */
+    npy_mapping(const std::string& path, bool writable);
+    /**
+     * @brief Create a new file of the given size, or truncate an existing one, and map it in read-write mode.
+     *
+     * The content of the file is zero-filled by the file system.
+     *
+     * @param path the path of the file to create.
+     * @param size the size in bytes of the new file, it must be greater than 0.
+     * @return std::shared_ptr<npy_mapping> the read-write mapping of the new file.
+     */
+    static std::shared_ptr<npy_mapping> create(const std::string& path, size_t size);
+
+    npy_mapping(const npy_mapping& other) = delete;
+    npy_mapping(npy_mapping&& other) = delete;
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~npy_mapping();
+
+    npy_mapping& operator=(const npy_mapping& other) = delete;
+    npy_mapping& operator=(npy_mapping&& other) = delete;
+
+    /**
+     * @brief The first byte of the mapped file.
+     *
+     * @return char* pointer to the mapped file, nullptr if the file is empty.
+     */
+    char* data() const noexcept;
+    /**
+     * @brief The size in bytes of the mapped file.
+     *
+     * @return size_t the size in bytes.
+     */
+    size_t size() const noexcept;
+    /**
+     * @brief Whether the mapping has been created in read-write mode.
+     *
+     * @return bool true if the mapping is writable.
+     */
+    bool writable() const noexcept;
+
+    /**
+     * @brief Flush the modified pages of a read-write mapping to the file.
+     *
+     * It does nothing on a read-only mapping.
+     *
+     * @param asynchronous false to wait until the pages are written, true to only schedule the write.
+     */
+    void sync(bool asynchronous = false);
+
+private:
+    npy_mapping() noexcept;
+
+    void map(int file_descriptor, bool writable);
+
+    char* _data; // The first byte of the mapping.
+    size_t _size; // The size of the mapping in bytes.
+    bool _writable; // True if the mapping is read-write.
+};
+
+#endif /* B6E1C7A2_3F58_4D0B_9C61_7A4E2D9F0B13 */
@@ -0,0 +1,195 @@
+#ifndef D4A9E6B2_7C31_4F85_B2D8_5E1A3C7F9B64
+#define D4A9E6B2_7C31_4F85_B2D8_5E1A3C7F9B64
+
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "npy_array/npy_array.h"
+#include "npy_array/npy_batch.h"
+#include "npy_array/npy_header.h"
+#include "npy_array/npy_thread_pool.h"
+#include "npy_array/npy_view.h"
+
+/**
+ * @brief The default number of shards an npy_sharded_array keeps open at once.
+ */
+const size_t npy_sharded_open_shards = 16;
+
+/**
+ * @brief Many array files, the shards, presented as a single array made of the rows of every shard, one shard after the other.
+ *
+ * The shards share the dtype and the dimensions following the first one, the number of rows of every shard can differ.
+ * Only their headers are read on construction, to index the first row of every shard. The shards in the native byte order
+ * are then mapped read-only lazily, and at most max_open_shards of them are kept open: the least recently used one is closed
+ * to open a new one. The rows of the shards in the opposite byte order, and the ranges of rows, are read with pread calls
+ * and swapped instead, so they do not need the shards to be open. The shards are expected to be left unchanged while the array is in use.
+ * The member functions can be called concurrently.
+ *
+ * @tparam T the type of the elements.
+ */
+template<typename T>
+class npy_sharded_array
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    class const_iterator;
+
+    /**
+     * @brief Index the rows of the given shards, reading their headers concurrently on the pool.
+     *
+     * @param paths the paths of the shards, in the order of their rows, at least one.
+     * @param max_open_shards the maximum number of shards kept open, at least one.
+     * @param pool the pool reading the headers.
+     * @throw std::invalid_argument if paths is empty or max_open_shards is zero.
+     * @throw npy_array_exception ill_formed_header if the dtype of a shard does not match T,
+     * unsupported_layout if a shard is in Fortran order or is 0-d, unmatched_shape_data if the dimensions of the rows of the shards differ,
+     * or the first error, in the order of the paths, that prevented reading the header of a shard.
+     */
+    explicit npy_sharded_array(const std::vector<std::string>& paths, size_type max_open_shards = npy_sharded_open_shards,
+                               npy_thread_pool& pool = npy_thread_pool::shared());
+
+    npy_sharded_array(const npy_sharded_array& other) = delete;
+    npy_sharded_array(npy_sharded_array&& other) = default;
+
+    npy_sharded_array& operator=(const npy_sharded_array& other) = delete;
+    npy_sharded_array& operator=(npy_sharded_array&& other) = default;
+
+    /**
+     * @brief The shape of the whole array: the total number of rows, followed by the dimensions of the rows.
+     */
+    const std::vector<size_type>& shape() const noexcept;
+    size_type size() const noexcept;
+    // The number of rows of the whole array.
+    size_type rows() const noexcept;
+    // The number of elements of a row.
+    size_type row_size() const noexcept;
+
+    size_type shard_count() const noexcept;
+    const std::string& shard_path(size_type shard) const;
+    const npy_header& shard_header(size_type shard) const;
+    // The index in the whole array of the first row of the shard.
+    size_type shard_first_row(size_type shard) const;
+
+    /**
+     * @brief The shard holding a row, and the index of the row in the shard.
+     *
+     * @throw std::out_of_range if the row exceeds the rows of the array.
+     */
+    std::pair<size_type, size_type> locate(size_type row) const;
+
+    /**
+     * @brief The array of a shard, opening it if it is not open.
+     *
+     * A shard in the native byte order is mapped, a shard in the opposite one is loaded whole in memory.
+     * The returned pointer keeps the shard alive, even after it is closed by the array to open other shards.
+     *
+     * @throw std::out_of_range if the shard does not exist, or the errors of the path constructor of npy_array.
+     */
+    std::shared_ptr<const npy_array<T>> shard(size_type shard) const;
+
+    /**
+     * @brief Copy a row into a new array having the dimensions of the rows.
+     *
+     * The shard of the row is opened if it is in the native byte order, otherwise the row alone is read and swapped.
+     *
+     * @throw std::out_of_range if the row exceeds the rows of the array.
+     */
+    npy_array<T> row(size_type row) const;
+
+    /**
+     * @brief Read a range of rows, crossing the boundaries of the shards, into a new array of shape (row_count, ...).
+     *
+     * The rows of every shard are read with pread calls issued in parallel on the pool, the shards do not need to be open.
+     *
+     * @throw std::out_of_range if the range exceeds the rows of the array.
+     * @throw npy_array_exception input_output_error if a shard cannot be read.
+     */
+    npy_array<T> load_rows(size_type first_row, size_type row_count, npy_thread_pool& pool = npy_thread_pool::shared()) const;
+
+    /**
+     * @brief Iterate over the rows of the whole array, opening every shard in the native byte order when its first row is reached,
+     * and reading the shards in the opposite byte order in blocks of rows.
+     */
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // The number of shards currently kept open.
+    size_type open_shards() const;
+
+private:
+    // The open shards, the most recently used first, and the position of every open shard in the list.
+    struct shard_cache
+    {
+        std::mutex mutex;
+        std::list<std::pair<size_type, std::shared_ptr<const npy_array<T>>>> shards;
+        std::unordered_map<size_type, typename std::list<std::pair<size_type, std::shared_ptr<const npy_array<T>>>>::iterator> positions;
+    };
+
+    std::vector<std::string> _paths;
+    std::vector<npy_header> _headers;
+    // The index of the first row of every shard, followed by the total number of rows.
+    std::vector<size_type> _first_rows;
+    std::vector<size_type> _shape;
+    std::vector<size_type> _row_shape;
+    size_type _row_size;
+    size_type _max_open_shards;
+    std::unique_ptr<shard_cache> _cache;
+
+    // Whether a shard has the native byte order, and can be mapped.
+    bool native(size_type shard) const noexcept;
+    // Read a range of rows, swapping the ones of the shards in the opposite byte order.
+    void read_rows(size_type first_row, size_type row_count, T* destination, npy_thread_pool& pool) const;
+    // A view of a row of an array of rows, like an open shard.
+    npy_view<const T> row_view(const npy_array<T>& rows, size_type row) const;
+};
+
+/**
+ * @brief Forward iterator over the rows of an npy_sharded_array, as views of the dimensions of the rows.
+ *
+ * The iterator keeps the rows it reads alive, either the shard of its row or a block of rows read from it.
+ * The view of a row is valid until the iterator moves past the last row of the shard or of the block.
+ */
+template<typename T>
+class npy_sharded_array<T>::const_iterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef npy_view<const T> value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const npy_view<const T>* pointer;
+    typedef npy_view<const T> reference;
+
+    const_iterator() noexcept : _array{nullptr}, _row{0}, _block{}, _block_first_row{0}, _block_rows{0} {}
+
+    reference operator*() const;
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    bool operator==(const const_iterator& other) const noexcept {return _row == other._row;}
+    bool operator!=(const const_iterator& other) const noexcept {return _row != other._row;}
+
+private:
+    friend class npy_sharded_array<T>;
+
+    const npy_sharded_array<T>* _array;
+    size_type _row;
+    // The rows holding the row, the shard or a block read from it, read when the row is first dereferenced.
+    mutable std::shared_ptr<const npy_array<T>> _block;
+    mutable size_type _block_first_row;
+    mutable size_type _block_rows;
+
+    const_iterator(const npy_sharded_array<T>* array, size_type row);
+};
+
+#include "npy_array/npy_sharded_array.ipp"
+
+#endif /* D4A9E6B2_7C31_4F85_B2D8_5E1A3C7F9B64 */
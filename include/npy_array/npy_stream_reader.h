@@ -0,0 +1,79 @@
+#ifndef E8D24B71_9A3C_4F05_B6E2_1D7C5A9E3F46
+#define E8D24B71_9A3C_4F05_B6E2_1D7C5A9E3F46
+
+#include <vector>
+#include <fstream>
+#include <type_traits>
+#include <string>
+#include <future>
+#include <stdint.h>
+
+#include "npy_array/npy_exception.h"
+#include "npy_array/npy_byteswap.h"
+#include "npy_array/npy_dtype.h"
+#include "npy_array/npy_header.h"
+
+/**
+ * @brief Sequential reader of the payload of a NumPy array file, chunk by chunk, for arrays larger than the memory.
+ *
+ * The header is parsed once, then every call to next() makes available the following chunk of whole rows along axis 0
+ * in a buffer owned by the reader and reused by all the chunks.
+ * When read-ahead is enabled, the chunk after the current one is read on a background thread into a second buffer,
+ * so that reading the file overlaps the processing of the current chunk.
+ *
+ * The data of a chunk is valid until the following call to next().
+ * The dtype of the file must be the one of T, in any byte order, and the payload must be stored in C order.
+ */
+template<typename T>
+class npy_stream_reader
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    npy_stream_reader(const std::string& array_path, size_type chunk_rows, bool read_ahead = false);
+
+    npy_stream_reader(const npy_stream_reader& other) = delete;
+    npy_stream_reader(npy_stream_reader&& other) = delete;
+
+    ~npy_stream_reader() = default;
+
+    npy_stream_reader& operator=(const npy_stream_reader& other) = delete;
+    npy_stream_reader& operator=(npy_stream_reader&& other) = delete;
+
+    bool next();
+
+    const npy_header& header() const noexcept;
+    size_type rows() const noexcept;
+    size_type row_size() const noexcept;
+
+    const T* data() const noexcept;
+    T* data() noexcept;
+    size_type chunk_rows() const noexcept;
+    size_type chunk_size() const noexcept;
+    size_type first_row() const noexcept;
+private:
+    // std::vector<bool> does not store bools contiguously, so the chunks of bool are stored as bytes.
+    typedef typename std::conditional<std::is_same<T, bool>::value, uint8_t, T>::type storage_type;
+
+    std::ifstream _array_file;
+    npy_header _header;
+    size_type _rows;
+    size_type _row_size;
+    size_type _max_chunk_rows;
+    bool _read_ahead;
+    std::vector<storage_type> _buffer;
+    std::vector<storage_type> _back_buffer;
+    size_type _chunk_rows;
+    size_type _first_row;
+    size_type _next_row;
+    size_type _read_row;
+    // Declared last so that a pending read is waited before the buffers and the file are destroyed.
+    std::future<size_type> _pending_read;
+
+    size_type read_chunk(std::vector<storage_type>& buffer);
+};
+
+#include "npy_array/npy_stream_reader.ipp"
+
+#endif /* E8D24B71_9A3C_4F05_B6E2_1D7C5A9E3F46 */
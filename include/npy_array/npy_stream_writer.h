@@ -0,0 +1,63 @@
+#ifndef A71F3D95_2C84_4B6E_8E17_4F0A6B2D9C53
+#define A71F3D95_2C84_4B6E_8E17_4F0A6B2D9C53
+
+#include <vector>
+#include <fstream>
+#include <string>
+#include <stdint.h>
+
+#include "npy_array/npy_exception.h"
+#include "npy_array/npy_dtype.h"
+#include "npy_array/npy_header.h"
+#include "npy_array/npy_array.h"
+
+/**
+ * @brief Sequential writer of a NumPy array file whose number of rows along axis 0 is not known in advance.
+ *
+ * The writer reserves a preamble large enough for any number of rows, then the producers append batches of rows,
+ * which are accumulated in a buffer and written to the file with large writes.
+ * The actual shape is patched in the preamble by close(), which is also called by the destructor if needed.
+ *
+ * Every row has the shape given at construction, so the final shape of the array is (rows, row_shape...).
+ */
+template<typename T>
+class npy_stream_writer
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    npy_stream_writer(const std::string& array_path, const std::vector<size_type>& row_shape, size_type buffer_size = 4 << 20);
+
+    npy_stream_writer(const npy_stream_writer& other) = delete;
+    npy_stream_writer(npy_stream_writer&& other) = delete;
+
+    ~npy_stream_writer();
+
+    npy_stream_writer& operator=(const npy_stream_writer& other) = delete;
+    npy_stream_writer& operator=(npy_stream_writer&& other) = delete;
+
+    void append(const T* rows_data, size_type rows);
+    void append(const npy_array<T>& rows);
+    void close();
+
+    const std::vector<size_type>& row_shape() const noexcept;
+    size_type row_size() const noexcept;
+    size_type rows() const noexcept;
+    bool is_open() const noexcept;
+private:
+    std::ofstream _array_file;
+    std::vector<size_type> _row_shape;
+    size_type _row_size;
+    size_type _rows;
+    size_type _preamble_size;
+    std::vector<char> _buffer;
+    size_type _buffer_used;
+
+    void flush_buffer();
+    std::vector<size_type> shape(size_type rows) const;
+};
+
+#include "npy_array/npy_stream_writer.ipp"
+
+#endif /* A71F3D95_2C84_4B6E_8E17_4F0A6B2D9C53 */
@@ -0,0 +1,104 @@
+#ifndef D5C04A8B_61E9_4F27_8B3A_9E2F7D1C6B84
+#define D5C04A8B_61E9_4F27_8B3A_9E2F7D1C6B84
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+/**
+ * @brief Fixed-size pool of worker threads executing the tasks submitted to it in FIFO order.
+ *
+ * The pool is used by the parallel kernels and I/O paths of the library.
+ * The destructor waits for all the submitted tasks to complete before joining the workers.
+ * A task must never wait for another task of the same pool, otherwise the pool can deadlock.
+ * For this reason parallel_for() called by a task runs the whole range in the task itself.
+ */
+class npy_thread_pool
+{
+public:
+    /**
+     * @brief Start a pool with the given number of worker threads.
+     *
+     * @param threads the number of workers, 0 to use the number of hardware threads.
+     */
+    explicit npy_thread_pool(size_t threads = 0);
+
+    npy_thread_pool(const npy_thread_pool& other) = delete;
+    npy_thread_pool(npy_thread_pool&& other) = delete;
+
+    ~npy_thread_pool();
+
+    npy_thread_pool& operator=(const npy_thread_pool& other) = delete;
+    npy_thread_pool& operator=(npy_thread_pool&& other) = delete;
+
+    /**
+     * @brief The number of worker threads.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Submit a task to the pool.
+     *
+     * @param task a callable taking no arguments.
+     * @return std::future the future of the value returned by the task, or of the exception it throws.
+     */
+    template<typename Function>
+    std::future<typename std::result_of<Function()>::type> submit(Function&& task)
+    {
+        typedef typename std::result_of<Function()>::type result_type;
+
+        // std::function requires a copyable callable, so the move-only packaged task is shared.
+        auto packaged_task = std::make_shared<std::packaged_task<result_type()>>(std::forward<Function>(task));
+        std::future<result_type> result = packaged_task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _tasks.emplace_back([packaged_task](){(*packaged_task)();});
+        }
+
+        _condition.notify_one();
+
+        return result;
+    }
+
+    /**
+     * @brief Split [begin, end) in contiguous ranges, one per worker, and run body on each range in parallel.
+     *
+     * The calling thread runs the last range and then waits for all the others.
+     * When called by a worker of this pool, the calling thread runs the whole range.
+     * The first exception thrown by body, if any, is rethrown after all the ranges completed.
+     *
+     * @param begin the first index.
+     * @param end one past the last index.
+     * @param body callable invoked as body(range_begin, range_end).
+     */
+    void parallel_for(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * @brief A pool shared by the whole library, having one worker per hardware thread.
+     */
+    static npy_thread_pool& shared();
+    /**
+     * @brief A pool shared by the whole library running blocking I/O, like the asynchronous loads and saves.
+     *
+     * It is distinct from shared(), so that its tasks can run parallel kernels on shared() without deadlocking.
+     */
+    static npy_thread_pool& io();
+
+private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping;
+
+    void work();
+};
+
+#endif /* D5C04A8B_61E9_4F27_8B3A_9E2F7D1C6B84 */
@@ -0,0 +1,28 @@
+#ifndef E8A3D6F1_2C47_4B9E_B05A_6F1D8C3E9A72
+#define E8A3D6F1_2C47_4B9E_B05A_6F1D8C3E9A72
+
+#include <cstddef>
+#include <vector>
+
+#include "npy_array/npy_thread_pool.h"
+
+/**
+ * @brief Copy a payload stored in Fortran order into a payload stored in C order, for the same shape.
+ *
+ * The element (i_0, ..., i_n-1) is read at offset i_0 + i_1 * d_0 + ... of the source and written at offset
+ * ... + i_n-2 * d_n-1 + i_n-1 of the destination.
+ * For every combination of the middle indexes, the first and the last axes form a 2-d strided transpose,
+ * which is performed in square tiles small enough to keep both the source and the destination lines in cache.
+ * The tiles are distributed on the threads of the given pool.
+ *
+ * @param source the Fortran-ordered payload.
+ * @param destination the C-ordered payload, it must not overlap with source.
+ * @param shape the shape of the array.
+ * @param pool the pool running the tiles.
+ */
+template<typename T>
+void npy_fortran_to_c_order(const T* source, T* destination, const std::vector<size_t>& shape, npy_thread_pool& pool);
+
+#include "npy_array/npy_transpose.ipp"
+
+#endif /* E8A3D6F1_2C47_4B9E_B05A_6F1D8C3E9A72 */
@@ -0,0 +1,143 @@
+#ifndef F3B8D1A6_9E42_4C7B_8D15_2A6C9F4E7B30
+#define F3B8D1A6_9E42_4C7B_8D15_2A6C9F4E7B30
+
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "npy_array/npy_array.h"
+
+/**
+ * @brief The value of a bound of npy_slice standing for the end of the axis in the direction of the step, like None in Python.
+ */
+const ptrdiff_t npy_slice_none = std::numeric_limits<ptrdiff_t>::min();
+
+/**
+ * @brief The range start:stop:step of the indexes of an axis, with the semantics of the slices of Python.
+ *
+ * Negative bounds count from the end of the axis, the bounds out of the axis are clamped to it,
+ * and a negative step walks the axis backwards. npy_slice{} is the whole axis.
+ */
+struct npy_slice
+{
+    ptrdiff_t start = npy_slice_none;
+    ptrdiff_t stop = npy_slice_none;
+    ptrdiff_t step = 1;
+
+    npy_slice() noexcept = default;
+    npy_slice(ptrdiff_t start, ptrdiff_t stop, ptrdiff_t step = 1) noexcept : start{start}, stop{stop}, step{step} {}
+};
+
+/**
+ * @brief Non-owning, strided view of the elements of an npy_array or of any other payload, like a mapping.
+ *
+ * A view is a pointer to a payload, an offset in elements to its first element, a shape and a stride in elements for every axis.
+ * Slicing, selecting, and transposing a view only compute a new offset, shape, and strides: no element is ever copied,
+ * and the writes through a view land in the payload. Use copy() to materialize a view into an array.
+ * The view does not keep the payload alive, it must not outlive the array or the mapping it refers to.
+ *
+ * @tparam T the type of the elements, const T for a read-only view.
+ */
+template<typename T>
+class npy_view
+{
+public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t stride_type;
+
+    /**
+     * @brief View the whole array, with the strides of its C or Fortran order.
+     */
+    template<typename U, typename Allocator>
+    npy_view(npy_array<U, Allocator>& array);
+    template<typename U, typename Allocator>
+    npy_view(const npy_array<U, Allocator>& array);
+
+    /**
+     * @brief View the elements of a payload.
+     *
+     * @param base the payload.
+     * @param offset the offset in elements of the first element of the view from base.
+     * @param shape the shape of the view.
+     * @param strides the distance in elements between two consecutive indexes of every axis, it can be negative.
+     * @throw std::invalid_argument if shape and strides do not have the same size.
+     */
+    npy_view(T* base, stride_type offset, std::vector<size_type> shape, std::vector<stride_type> strides);
+
+    /**
+     * @brief View the range of indexes of every axis, the axes following the given slices are taken whole.
+     *
+     * @throw std::invalid_argument if there are more slices than axes, or a step is zero.
+     */
+    npy_view slice(std::initializer_list<npy_slice> slices) const;
+    /**
+     * @brief View a range of indexes of one axis, the other axes are taken whole.
+     *
+     * @throw std::invalid_argument if the axis does not exist, or the step is zero.
+     */
+    npy_view slice(size_type axis, const npy_slice& range) const;
+
+    /**
+     * @brief View the elements at one index of an axis, the axis is removed from the view: select(0, i) is the i-th row.
+     *
+     * @throw std::invalid_argument if the axis does not exist, std::out_of_range if the index is out of the axis.
+     */
+    npy_view select(size_type axis, size_type index) const;
+
+    /**
+     * @brief View the axes in reverse order, like the transpose of a matrix.
+     */
+    npy_view transpose() const;
+    /**
+     * @brief View the axes in the given order: the i-th axis of the view is the axes[i]-th axis of this view.
+     *
+     * @throw std::invalid_argument if axes is not a permutation of the axes.
+     */
+    npy_view transpose(const std::vector<size_type>& axes) const;
+
+    /**
+     * @brief Whether the elements are laid out in C order without gaps, so that they can be read as a plain array from data().
+     */
+    bool contiguous() const noexcept;
+
+    /**
+     * @brief Copy the elements of the view into a new C-ordered array of the same shape.
+     *
+     * The trailing axes laid out without gaps are copied as blocks, so the copy of a view whose inner dimensions
+     * are contiguous, like a range of rows, is a sequence of plain copies.
+     */
+    npy_array<typename std::remove_const<T>::type> copy() const;
+
+    reference operator[](std::initializer_list<size_type> indexes) const noexcept;
+    /**
+     * @throw std::out_of_range if the number of indexes does not match the number of axes, or an index is out of its axis.
+     */
+    reference at(std::initializer_list<size_type> indexes) const;
+
+    const std::vector<size_type>& shape() const noexcept;
+    const std::vector<stride_type>& strides() const noexcept;
+    stride_type offset() const noexcept;
+    size_type size() const noexcept;
+
+    // The first element of the view.
+    T* data() const noexcept;
+
+private:
+    T* _base;
+    stride_type _offset;
+    std::vector<size_type> _shape;
+    std::vector<stride_type> _strides;
+
+    void check_axis(size_type axis) const;
+    // Narrow an axis of this view to a range, in place.
+    void narrow(size_type axis, const npy_slice& range);
+};
+
+#include "npy_array/npy_view.ipp"
+
+#endif /* F3B8D1A6_9E42_4C7B_8D15_2A6C9F4E7B30 */
@@ -0,0 +1,107 @@
+#ifndef A41F7C93_D82E_4E65_9B0C_3C7E5A1D64F9
+#define A41F7C93_D82E_4E65_9B0C_3C7E5A1D64F9
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "npy_array/npy_array.h"
+#include "npy_array/npy_exception.h"
+#include "npy_array/npy_header.h"
+#include "npy_array/npy_mapping.h"
+
+/**
+ * @brief A member of a .npz archive, that is a NumPy array file stored in the ZIP archive.
+ */
+struct npz_member
+{
+    std::string name; // The name of the member without the '.npy' extension, like the keys of numpy.load().
+    npy_header header; // The header of the embedded array file.
+    bool compressed; // True if the member is deflate-compressed, false if it is stored.
+    uint32_t crc32; // The CRC-32 of the uncompressed array file.
+    uint64_t compressed_size; // The size in bytes of the member data in the archive.
+    uint64_t uncompressed_size; // The size in bytes of the array file.
+    uint64_t data_offset; // The offset in bytes of the member data from the beginning of the archive.
+};
+
+/**
+ * @brief Reader of .npz archives, as written by numpy.savez() and numpy.savez_compressed().
+ *
+ * The archive is memory-mapped read-only and its central directory is parsed once by the constructor,
+ * together with the header of every '.npy' member, ZIP64 archives included.
+ * The payload of a member is read only when the member is loaded: loading a member never touches the others.
+ * Stored members can be loaded zero-copy, as arrays referring directly to the mapping of the archive.
+ * Members that are not NumPy array files are ignored.
+ *
+ * Errors in the ZIP structure are reported as npy_array_exception with type invalid_archive,
+ * errors in the embedded headers like the ones of npy_array.
+ */
+class npz_archive
+{
+public:
+    typedef size_t size_type;
+
+    /**
+     * @brief Open the archive at the given path and read its central directory.
+     *
+     * @param archive_path the path of the .npz file.
+     * @throw npy_array_exception input_output_error, invalid_archive, or the errors of npy_header::read().
+     */
+    explicit npz_archive(const std::string& archive_path);
+
+    /**
+     * @brief The members of the archive, in the order of the central directory.
+     */
+    const std::vector<npz_member>& members() const noexcept;
+    /**
+     * @brief The names of the members, in the order of the central directory.
+     */
+    std::vector<std::string> names() const;
+    size_type size() const noexcept;
+
+    bool contains(const std::string& name) const;
+    /**
+     * @brief The member having the given name.
+     *
+     * @throw std::out_of_range if the archive has no such member.
+     */
+    const npz_member& member(const std::string& name) const;
+
+    /**
+     * @brief Load the member having the given name.
+     *
+     * With map_read_only, a stored member whose payload is suitably aligned and has the native byte order
+     * refers directly to the mapping of the archive, and the mapping is kept alive by the array.
+     * In any other case, compressed members included, the payload is copied in memory owned by the array,
+     * and the CRC of the member is checked. The CRC of a member referred to by the array is not checked, since it is not read.
+     * map_read_write is not supported, since the archive is mapped read-only.
+     *
+     * @param name the name of the member, without the '.npy' extension.
+     * @param mode how the payload is made available to the array.
+     * @param allocator the allocator of the payload.
+     * @return npy_array<T, Allocator> the array.
+     * @throw std::out_of_range if the archive has no such member.
+     * @throw npy_array_exception ill_formed_header if the dtype does not match T, invalid_archive if the member is corrupted,
+     * input_output_error with map_read_write.
+     */
+    template<typename T, typename Allocator = std::allocator<T>>
+    npy_array<T, Allocator> load(const std::string& name, npy_array_mode mode = npy_array_mode::load_in_memory,
+                                 const Allocator& allocator = Allocator()) const;
+
+private:
+    std::shared_ptr<npy_mapping> _mapping;
+    std::vector<npz_member> _members;
+    std::map<std::string, size_type> _indexes; // The index of every member in _members, by name.
+
+    void read_central_directory();
+    npy_header read_member_header(const npz_member& member) const;
+    // Copy or inflate the payload of the member, the bytes following its preamble, into destination.
+    void read_payload(const npz_member& member, char* destination) const;
+};
+
+#include "npy_array/npz_archive.ipp"
+
+#endif /* A41F7C93_D82E_4E65_9B0C_3C7E5A1D64F9 */
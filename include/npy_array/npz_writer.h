@@ -0,0 +1,115 @@
+#ifndef F2B87E14_95C3_4A0D_8D6E_1B4A9C7F3E25
+#define F2B87E14_95C3_4A0D_8D6E_1B4A9C7F3E25
+
+#include <cstddef>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "npy_array/npy_array.h"
+#include "npy_array/npy_exception.h"
+#include "npy_array/npy_header.h"
+#include "npy_array/npy_thread_pool.h"
+
+/**
+ * @brief How the members of a .npz archive are written.
+ *
+ * npz_stored: the array files are stored as they are, like numpy.savez().
+ * npz_deflated: the array files are deflate-compressed, like numpy.savez_compressed().
+ */
+enum npz_compression
+{
+    npz_stored,
+    npz_deflated
+};
+
+/**
+ * @brief Writer of .npz archives, readable by numpy.load() and by npz_archive.
+ *
+ * Every array added is written right away as a member of the archive, and the central directory is written by close().
+ * A deflated member is split in chunks of chunk_size bytes compressed in parallel on a thread pool,
+ * each one as an independent sequence of deflate blocks terminated by a sync flush, so that their concatenation
+ * is a single valid deflate stream, and the CRC-32 of the chunks are combined.
+ * The CRC-32 of stored members is computed in parallel in the same way.
+ * ZIP64 records are written only for the members and the archives that need them.
+ *
+ * Errors while writing are reported as npy_array_exception with type input_output_error.
+ */
+class npz_writer
+{
+public:
+    typedef size_t size_type;
+
+    /**
+     * @brief Create the archive at the given path, truncating an existing file.
+     *
+     * @param archive_path the path of the .npz file.
+     * @param compression whether the members are stored or deflated.
+     * @param level the deflate compression level, from 1 (fastest) to 9 (smallest), ignored for stored members.
+     * @param pool the pool compressing the chunks.
+     * @param chunk_size the size in bytes of the chunks compressed independently.
+     */
+    npz_writer(const std::string& archive_path, npz_compression compression = npz_compression::npz_stored, int level = 6,
+               npy_thread_pool& pool = npy_thread_pool::shared(), size_type chunk_size = 1 << 20);
+
+    npz_writer(const npz_writer& other) = delete;
+    npz_writer& operator=(const npz_writer& other) = delete;
+
+    /**
+     * @brief Close the archive if it is still open, ignoring any error.
+     */
+    ~npz_writer();
+
+    /**
+     * @brief Write an array as the member name + '.npy'.
+     *
+     * @param name the name of the member, without the '.npy' extension.
+     * @param array the array to write.
+     * @throw std::invalid_argument if the archive already has a member with the same name.
+     * @throw npy_array_exception input_output_error, or generic if the archive has been closed.
+     */
+    template<typename T>
+    void add(const std::string& name, const npy_array<T>& array);
+
+    /**
+     * @brief Write the central directory and close the file.
+     */
+    void close();
+
+    bool is_open() const noexcept;
+    size_type size() const noexcept;
+
+private:
+    // The central directory record of a member written.
+    struct entry
+    {
+        std::string file_name;
+        uint16_t method;
+        uint32_t crc32;
+        uint64_t compressed_size;
+        uint64_t uncompressed_size;
+        uint64_t local_header_offset;
+    };
+
+    std::ofstream _archive_stream;
+    npz_compression _compression;
+    int _level;
+    npy_thread_pool& _pool;
+    size_type _chunk_size;
+    std::vector<entry> _entries;
+    std::set<std::string> _names;
+
+    void add_member(const std::string& name, const std::string& preamble, const char* payload, size_type payload_size);
+    // Compute the CRC-32 of the preamble followed by the payload, splitting the payload in chunks on the pool.
+    uint32_t parallel_crc32(const std::string& preamble, const char* payload, size_type payload_size);
+    void write_stored(entry& member_entry, const std::string& preamble, const char* payload, size_type payload_size);
+    void write_deflated(entry& member_entry, const std::string& preamble, const char* payload, size_type payload_size);
+    std::string local_header(const entry& member_entry, bool zip64) const;
+    void write_central_directory();
+};
+
+#include "npy_array/npz_writer.ipp"
+
+#endif /* F2B87E14_95C3_4A0D_8D6E_1B4A9C7F3E25 */
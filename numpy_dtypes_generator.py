@@ -29,8 +29,8 @@ if __name__ == "__main__":
     valid_combinations += kinds[1:]
     valid_combinations += ["|b1", "|i1", "|u1"]
     valid_combinations += [b + k for k in kinds[1:] for b in byte_orders[:-1]]
-    valid_combinations += ["i2", "i4", "i8", "u2", "u4", "u8", "f4", "f8", "f16", "c8", "c16", "c32"]
-    valid_combinations += [b + ks for b in byte_orders[:-1] for ks in ["i2", "i4", "i8", "u2", "u4", "u8", "f4", "f8", "f16", "c8", "c16", "c32"]]
+    valid_combinations += ["i2", "i4", "i8", "u2", "u4", "u8", "f2", "f4", "f8", "f16", "c8", "c16", "c32"]
+    valid_combinations += [b + ks for b in byte_orders[:-1] for ks in ["i2", "i4", "i8", "u2", "u4", "u8", "f2", "f4", "f8", "f16", "c8", "c16", "c32"]]
     with open("./test_resources/valid_dtype_strings.txt", "w") as valid_file:
         valid_file.write("\n".join(valid_combinations))
     for k in kinds:
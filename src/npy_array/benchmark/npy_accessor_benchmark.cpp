@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+#include "npy_array/npy_array.h"
+
+// Sum every element of a 3-d array through each of the ways of indexing it, in C order.
+const size_t benchmark_side = 128;
+
+npy_array<float> benchmark_array()
+{
+    npy_array<float> array{{benchmark_side, benchmark_side, benchmark_side}};
+    std::iota(array.begin(), array.end(), 0.0f);
+
+    return array;
+}
+
+static void BM_InitializerListIndex(benchmark::State& state)
+{
+    const npy_array<float> array = benchmark_array();
+
+    for(auto _ : state)
+    {
+        float sum = 0.0f;
+
+        for(size_t i = 0; i < benchmark_side; i++)
+            for(size_t j = 0; j < benchmark_side; j++)
+                for(size_t k = 0; k < benchmark_side; k++)
+                    sum += array[{i, j, k}];
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * array.size());
+}
+BENCHMARK(BM_InitializerListIndex);
+
+static void BM_InitializerListAt(benchmark::State& state)
+{
+    const npy_array<float> array = benchmark_array();
+
+    for(auto _ : state)
+    {
+        float sum = 0.0f;
+
+        for(size_t i = 0; i < benchmark_side; i++)
+            for(size_t j = 0; j < benchmark_side; j++)
+                for(size_t k = 0; k < benchmark_side; k++)
+                    sum += array.at({i, j, k});
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * array.size());
+}
+BENCHMARK(BM_InitializerListAt);
+
+static void BM_VariadicIndex(benchmark::State& state)
+{
+    const npy_array<float> array = benchmark_array();
+
+    for(auto _ : state)
+    {
+        float sum = 0.0f;
+
+        for(size_t i = 0; i < benchmark_side; i++)
+            for(size_t j = 0; j < benchmark_side; j++)
+                for(size_t k = 0; k < benchmark_side; k++)
+                    sum += array(i, j, k);
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * array.size());
+}
+BENCHMARK(BM_VariadicIndex);
+
+static void BM_Accessor(benchmark::State& state)
+{
+    const npy_array<float> array = benchmark_array();
+    const npy_accessor<const float, 3> accessor = array.accessor<3>();
+
+    for(auto _ : state)
+    {
+        float sum = 0.0f;
+
+        for(size_t i = 0; i < benchmark_side; i++)
+            for(size_t j = 0; j < benchmark_side; j++)
+                for(size_t k = 0; k < benchmark_side; k++)
+                    sum += accessor(i, j, k);
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * array.size());
+}
+BENCHMARK(BM_Accessor);
+
+// The lower bound: the payload summed as a flat sequence.
+static void BM_Flat(benchmark::State& state)
+{
+    const npy_array<float> array = benchmark_array();
+
+    for(auto _ : state)
+    {
+        float sum = 0.0f;
+
+        for(size_t i = 0; i < array.size(); i++)
+            sum += array[i];
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * array.size());
+}
+BENCHMARK(BM_Flat);
+
+BENCHMARK_MAIN();
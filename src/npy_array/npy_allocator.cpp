@@ -0,0 +1,74 @@
+#include "npy_array/npy_allocator.h"
+
+#include <sys/mman.h>
+
+namespace
+{
+    size_t huge_page_round_up(size_t size) noexcept
+    {
+        return (size + npy_huge_page_size - 1) / npy_huge_page_size * npy_huge_page_size;
+    }
+}
+
+void* npy_aligned_allocate(size_t size, size_t alignment)
+{
+    void* pointer = nullptr;
+
+    // posix_memalign may return null for a zero size, which must not be mistaken for a failure.
+    if(::posix_memalign(&pointer, alignment, size == 0 ? 1 : size) != 0)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return pointer;
+}
+
+void npy_aligned_deallocate(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void* npy_huge_page_allocate(size_t size)
+{
+    if(size < npy_huge_page_size)
+    {
+        return npy_aligned_allocate(size, 64);
+    }
+
+    // Map one more huge page, so that a huge page aligned range can be cut out of the mapping.
+    const size_t length = huge_page_round_up(size);
+    void* mapping = ::mmap(nullptr, length + npy_huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if(mapping == MAP_FAILED)
+    {
+        throw std::bad_alloc{};
+    }
+
+    char* begin = static_cast<char*>(mapping);
+    char* aligned_begin = reinterpret_cast<char*>(huge_page_round_up(reinterpret_cast<size_t>(begin)));
+
+    // Unmap the unaligned head and the unused tail.
+    if(aligned_begin != begin)
+    {
+        ::munmap(begin, aligned_begin - begin);
+    }
+
+    ::munmap(aligned_begin + length, begin + length + npy_huge_page_size - (aligned_begin + length));
+
+#ifdef MADV_HUGEPAGE
+    ::madvise(aligned_begin, length, MADV_HUGEPAGE);
+#endif
+
+    return aligned_begin;
+}
+
+void npy_huge_page_deallocate(void* pointer, size_t size) noexcept
+{
+    if(size < npy_huge_page_size)
+    {
+        npy_aligned_deallocate(pointer);
+        return;
+    }
+
+    ::munmap(pointer, huge_page_round_up(size));
+}
@@ -0,0 +1,59 @@
+#include "npy_array/npy_any_array.h"
+
+npy_any_array::npy_any_array(const std::string& array_path, npy_array_mode mode)
+    : _holder{}
+{
+    std::ifstream array_file{};
+
+    array_file.exceptions(std::ifstream::failbit | std::ifstream::badbit | std::ifstream::eofbit);
+
+    try
+    {
+        array_file.open(array_path);
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    npy_header header = npy_header::read(array_file);
+
+    // The header is read only once, the payload is loaded by the npy_array of the matching type.
+    _holder = npy_dtype_dispatch(header.dtype(), [&](auto* tag) -> std::unique_ptr<holder_base>
+    {
+        typedef std::remove_pointer_t<decltype(tag)> value_type;
+        return std::unique_ptr<holder_base>{new holder<value_type>{npy_array<value_type>{array_file, array_path, header, mode}}};
+    });
+}
+
+npy_any_array::npy_any_array(const npy_any_array& other)
+    : _holder{other._holder ? other._holder->clone() : nullptr} {}
+
+npy_any_array& npy_any_array::operator=(const npy_any_array& other)
+{
+    if(this != &other)
+    {
+        _holder = other._holder ? other._holder->clone() : nullptr;
+    }
+
+    return *this;
+}
+
+const npy_dtype& npy_any_array::dtype() const noexcept {return _holder->dtype();}
+const std::vector<size_t>& npy_any_array::shape() const noexcept {return _holder->shape();}
+bool npy_any_array::fortran_order() const noexcept {return _holder->fortran_order();}
+bool npy_any_array::mapped() const noexcept {return _holder->mapped();}
+
+void* npy_any_array::data() noexcept {return _holder->data();}
+const void* npy_any_array::data() const noexcept {return _holder->data();}
+
+size_t npy_any_array::size() const noexcept {return _holder->size();}
+size_t npy_any_array::byte_size() const noexcept {return _holder->size() * _holder->dtype().item_size();}
+
+void npy_any_array::save(const std::string& array_path, npy_endianness byte_order) const
+{
+    this->visit([&](const auto& array) -> void
+    {
+        array.save(array_path, byte_order);
+    });
+}
@@ -0,0 +1,72 @@
+#include "npy_array/npy_any_array.h"
+
+template<typename T>
+npy_any_array::holder<T>::holder(npy_array<T>&& held_array)
+    : array{std::move(held_array)} {}
+
+template<typename T>
+std::unique_ptr<npy_any_array::holder_base> npy_any_array::holder<T>::clone() const
+{
+    return std::unique_ptr<holder_base>{new holder<T>{npy_array<T>{array}}};
+}
+
+template<typename T> const npy_dtype& npy_any_array::holder<T>::dtype() const noexcept {return array.dtype();}
+template<typename T> const std::vector<size_t>& npy_any_array::holder<T>::shape() const noexcept {return array.shape();}
+template<typename T> bool npy_any_array::holder<T>::fortran_order() const noexcept {return array.fortran_order();}
+template<typename T> bool npy_any_array::holder<T>::mapped() const noexcept {return array.mapped();}
+template<typename T> void* npy_any_array::holder<T>::data() noexcept {return array.data();}
+template<typename T> size_t npy_any_array::holder<T>::size() const noexcept {return array.size();}
+
+template<typename T>
+npy_any_array::npy_any_array(npy_array<T>&& array)
+    : _holder{new holder<T>{std::move(array)}} {}
+
+template<typename T>
+bool npy_any_array::is() const noexcept
+{
+    return dynamic_cast<const holder<T>*>(_holder.get()) != nullptr;
+}
+
+template<typename T>
+npy_array<T>& npy_any_array::as()
+{
+    auto typed_holder = dynamic_cast<holder<T>*>(_holder.get());
+
+    if(typed_holder == nullptr)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+    }
+
+    return typed_holder->array;
+}
+
+template<typename T>
+const npy_array<T>& npy_any_array::as() const
+{
+    auto typed_holder = dynamic_cast<const holder<T>*>(_holder.get());
+
+    if(typed_holder == nullptr)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+    }
+
+    return typed_holder->array;
+}
+
+template<typename Visitor>
+auto npy_any_array::visit(Visitor&& visitor) -> decltype(visitor(std::declval<npy_array<bool>&>()))
+{
+    return npy_dtype_dispatch(this->dtype(), [&](auto* tag) -> decltype(visitor(std::declval<npy_array<bool>&>()))
+    {
+        return visitor(this->as<std::remove_pointer_t<decltype(tag)>>());
+    });
+}
+
+template<typename Visitor>
+auto npy_any_array::visit(Visitor&& visitor) const -> decltype(visitor(std::declval<const npy_array<bool>&>()))
+{
+    return npy_dtype_dispatch(this->dtype(), [&](auto* tag) -> decltype(visitor(std::declval<const npy_array<bool>&>()))
+    {
+        return visitor(this->as<std::remove_pointer_t<decltype(tag)>>());
+    });
+}
@@ -1,200 +1,244 @@
 #include "npy_array/npy_array.h"
 
+// The size in bytes of the chunks in which a payload is byte swapped, small enough to stay in cache.
+const size_t swap_chunk_byte_size = 1 << 20;
+// The preambles up to this size are formatted in a buffer on the stack when saving.
+const size_t preamble_stack_size = 1024;
+
+// Adopt a vector as the payload of an array when it is allocated like the payload would be,
+// otherwise copy it into the storage, as for booleans or for another allocator.
+template<typename S, typename A>
+void move_into_storage(std::vector<S, A>& storage, std::vector<S>& adopted, std::vector<S>&& data, std::true_type)
+{
+    adopted = std::move(data);
+}
+
+template<typename S, typename A, typename T, typename B, typename Adoptable>
+void move_into_storage(std::vector<S, A>& storage, std::vector<S>& adopted, std::vector<T, B>&& data, Adoptable)
+{
+    storage.assign(data.cbegin(), data.cend());
+}
+
 template<typename Iterator>
 size_t multiplies_vector(const Iterator start, const Iterator end)
 {
     return std::accumulate(start, end, size_t(1), std::multiplies<size_t>());
 }
 
-template<class T> 
-bool npy_array<T>::check_magic_string(std::ifstream &array_file)
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::check_for_strides()
 {
-    std::string magic_string{};
-    magic_string.resize(6);
+    if(_strides.size() == 0)
+    {
+        _strides.resize(_shape.size());
 
-    array_file.read(&magic_string[0], magic_string.size());
+        size_type stride = 1;
 
-    return magic_string == "\x93NUMPY";
+        if(_fortran_order)
+        {
+            // In Fortran order the stride of a dimension is the product of all the preceding dimensions.
+            for(size_type i = 0; i < _shape.size(); i++)
+            {
+                _strides[i] = stride;
+                stride *= _shape[i];
+            }
+        }
+        else
+        {
+            // The stride of a dimension is the product of all the following dimensions, computed as a running product from the last one.
+            for(size_type i = _shape.size(); i > 0; i--)
+            {
+                _strides[i - 1] = stride;
+                stride *= _shape[i - 1];
+            }
+        }
+    }
 }
 
-template<class T> 
-bool npy_array<T>::check_version(std::ifstream &array_file)
-{
-    uint8_t major_version;
-    uint8_t minor_version;
 
-    array_file.read(reinterpret_cast<char*>(&major_version), 1);
-    array_file.read(reinterpret_cast<char*>(&minor_version), 1);
 
-    return major_version == 0x1;
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::attach_data() noexcept
+{
+    if(!_adopted_data.empty())
+    {
+        _pointer = reinterpret_cast<T*>(_adopted_data.data());
+        _size = _adopted_data.size();
+    }
+    else
+    {
+        _pointer = reinterpret_cast<T*>(_data.data());
+        _size = _data.size();
+    }
 }
 
-template<class T> 
-std::string npy_array<T>::read_header(std::ifstream &array_file)
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(const std::string& array_path, npy_array_mode mode, const Allocator& allocator)
+    : _shape{}, _data(storage_allocator(allocator)), _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{}, _fortran_order{false}
 {
-    std::string header;
-    uint16_t header_length;
-
-    array_file.read(reinterpret_cast<char*>(&header_length), 2);
-
-    header.resize(header_length);
-
-    array_file.read(&header[0], header_length);
+    this->open(array_path, mode, nullptr);
+}
 
-    return header;
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(const std::string& array_path, npy_array_mode mode, npy_thread_pool& pool, const Allocator& allocator)
+    : _shape{}, _data(storage_allocator(allocator)), _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{}, _fortran_order{false}
+{
+    this->open(array_path, mode, &pool);
 }
 
-template<typename T>
-void npy_array<T>::parse_header(const std::string& header)
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::open(const std::string& array_path, npy_array_mode mode, npy_thread_pool* pool)
 {
-    std::array<char, 5> charaters_to_remove{' ', '\n', '{', '}', '\''};
-    // Create a copy of the header string because we need to modify it.
-    auto header_copy{header};
-    // Remove the unwanted characters from the header copy string.
-    header_copy.erase(std::remove_if(header_copy.begin(), header_copy.end(), [&](char c)
-    {
-        return std::find(charaters_to_remove.cbegin(), charaters_to_remove.cend(), c) != charaters_to_remove.cend();
-    }), header_copy.end());
+    std::ifstream array_file{};
 
-    // Find the indexes of the left and right brackes within the header string.
-    // Both key value pairs and shape elements are comma-separeted.
-    // We need to change the separation of the shape by replacing the comma in the shape string with another token that easily recognizable, like an underscore.
-    auto left_bracket_index = std::find(header_copy.begin(), header_copy.end(), '(');
-    auto right_bracket_index = std::find(header_copy.begin(), header_copy.end(), ')');
+    array_file.exceptions(std::ifstream::failbit | std::ifstream::badbit | std::ifstream::eofbit);
 
-    if(left_bracket_index != header_copy.end() && right_bracket_index != header_copy.end())
+    try
     {
-        std::replace(left_bracket_index, right_bracket_index, ',', '_');
+        array_file.open(array_path);
     }
-    else
+    catch(const std::ios_base::failure& failure_exception)
     {
-        throw boost::regex_error{boost::regex_constants::error_unknown};
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
     }
-    
 
-    std::vector<std::string> header_key_value_pairs;
+    npy_header header = npy_header::read(array_file);
+
+    this->load(array_file, array_path, header, mode, pool);
+}
 
-    boost::split(header_key_value_pairs, header_copy, [](char c){return c == ',';});
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(std::ifstream& array_file, const std::string& array_path, const npy_header& header, npy_array_mode mode,
+                                   const Allocator& allocator)
+    : _shape{}, _data(storage_allocator(allocator)), _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{}, _fortran_order{false}
+{
+    this->load(array_file, array_path, header, mode);
+}
 
-    for(auto& key_value_pair : header_key_value_pairs)
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::load(std::ifstream& array_file, const std::string& array_path, const npy_header& header, npy_array_mode mode, npy_thread_pool* pool)
+{
+    try
     {
-        std::vector<std::string> key_value{};
-        boost::split(key_value, key_value_pair, [](char c){return c == ':';});
+        // A payload having the opposite byte order of the machine is swapped while it is read.
+        bool swap_bytes = header.dtype() != npy_dtype::from_type<T>();
+
+        if(header.dtype().with_byte_order(npy_endianness::native) != npy_dtype::from_type<T>())
+        {
+            throw npy_array_exception{npy_array_exception_type::ill_formed_header};
+        }
+
+        _shape = header.shape();
+        _dtype = npy_dtype::from_type<T>();
+        _fortran_order = header.fortran_order();
 
-        if(key_value[0] == "descr")
+        if(mode == npy_array_mode::load_in_memory || mode == npy_array_mode::load_c_order)
         {
-            npy_dtype requested_dtype = npy_dtype::from_string(key_value[1]);
+            _data.resize(header.size());
+            this->attach_data();
 
-            if(requested_dtype && npy_dtype::from_type<T>() == requested_dtype)
+            if(swap_bytes)
             {
-                _dtype = std::move(requested_dtype);
+                // Swap every chunk right after reading it, while it is still in cache.
+                const size_type chunk_size = std::max(size_type(1), swap_chunk_byte_size / sizeof(T));
+
+                for(size_type offset = 0; offset < _size; offset += chunk_size)
+                {
+                    size_type count = std::min(chunk_size, _size - offset);
+                    array_file.read(reinterpret_cast<char*>(_pointer + offset), count * sizeof(T));
+                    npy_byteswap(_pointer + offset, count, header.dtype());
+                }
             }
             else
             {
-                throw boost::regex_error{boost::regex_constants::error_unknown};
+                array_file.read(reinterpret_cast<char*>(_pointer), _size * sizeof(T));
             }
-            
         }
-        else if(key_value[0] == "fortran_order")
+        else if(mode == npy_array_mode::load_direct)
         {
-            if(!(key_value[1] == "False" || key_value[1] == "True"))
-            {
-                throw boost::regex_error{boost::regex_constants::error_unknown};
-            }
+            // The payload is placed in memory like it is in the file relative to the pages, so that the aligned reads land in place:
+            // the storage has room for the page alignment and for the bytes preceding the payload in its first page.
+            const size_type lead = header.payload_offset() % npy_direct_alignment;
 
-            _fortran_order = key_value[1] == "False" ? false : true;
-        }
-        else if(key_value[0] == "shape")
-        {
-            std::vector<std::string> shape_values{};
-            boost::split(shape_values, key_value[1].substr(1, key_value[1].size() - 2), [](char c){return c == '_';});
-            shape_values.erase(std::remove_if(shape_values.begin(), shape_values.end(), [](std::string& s)
-            {
-                return s.empty();
-            }), shape_values.end());
-            _shape.reserve(shape_values.size());
-            std::transform(shape_values.cbegin(), shape_values.cend(), std::back_inserter(_shape), [](std::string shape_value) -> size_type
+            if(lead % alignof(storage_type) == 0)
             {
-                return std::strtoul(shape_value.data(), nullptr, 10);
-            });
+                _data.resize(header.size() + (npy_direct_alignment - 1 + lead + sizeof(storage_type) - 1) / sizeof(storage_type));
 
-            if(std::any_of(_shape.cbegin(), _shape.cend(), [](size_type d){return d == 0;}))
+                const uintptr_t address = reinterpret_cast<uintptr_t>(_data.data());
+                _pointer = reinterpret_cast<T*>((address + npy_direct_alignment - 1) / npy_direct_alignment * npy_direct_alignment + lead);
+                _size = header.size();
+            }
+            else
             {
-                throw boost::regex_error{boost::regex_constants::error_unknown};
+                _data.resize(header.size());
+                this->attach_data();
             }
 
-            _strides.reserve(shape_values.size());
-            for(std::vector<size_type>::const_iterator i = std::next(_shape.cbegin()); i != _shape.cend(); i = std::next(i))
+            array_file.close();
+
+            npy_direct_read(array_path, header.payload_offset(), reinterpret_cast<char*>(_pointer), header.byte_size(), pool ? *pool : npy_thread_pool::shared());
+
+            if(swap_bytes)
             {
-                _strides.push_back(multiplies_vector(i, _shape.cend()));
+                npy_byteswap(_pointer, _size, header.dtype());
             }
-            _strides.push_back(1);
         }
-        else if(key_value[0] == "") continue;
-        else
+        else if(mode == npy_array_mode::load_parallel)
         {
-            throw boost::regex_error{boost::regex_constants::error_unknown};
-        }
-        
-    }
-}
+            _data.resize(header.size());
+            this->attach_data();
 
-template<class T> 
-void npy_array<T>::check_for_strides()
-{
-    if(_strides.size() == 0)
-    {
-        _strides.reserve(_shape.size());
+            array_file.close();
 
-        for(auto i = std::next(_shape.cbegin()); i != _shape.cend(); i = std::next(i))
-        {
-            _strides.push_back(multiplies_vector(i, _shape.cend()));
-        }
-        _strides.push_back(1);
-    }
-}
+            // Every range is swapped right after being read, by the thread which read it.
+            const npy_dtype file_dtype = header.dtype();
+            std::function<void(char*, size_t)> swap{};
 
+            if(swap_bytes)
+            {
+                swap = [&file_dtype](char* bytes, size_t length)
+                {
+                    npy_byteswap(bytes, length / sizeof(T), file_dtype);
+                };
+            }
 
+            npy_parallel_read(array_path, header.payload_offset(), reinterpret_cast<char*>(_pointer), header.byte_size(),
+                              pool ? *pool : npy_thread_pool::shared(), npy_parallel_chunk_size, swap);
+        }
+        else
+        {
+            // A mapping cannot be swapped without modifying the file, or giving up sharing its pages.
+            if(swap_bytes)
+            {
+                throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+            }
 
-template<typename T>
-npy_array<T>::npy_array(const std::string& array_path)
-    : _shape{}, _data{}, _strides{}, _dtype{}, _fortran_order{false}
-{
-    std::ifstream array_file{};
-    std::string header{};
+            array_file.close();
 
-    array_file.exceptions(std::ifstream::failbit | std::ifstream::badbit | std::ifstream::eofbit);
+            _mapping = std::make_shared<npy_mapping>(array_path, mode == npy_array_mode::map_read_write);
 
-    try
-    {
-        array_file.open(array_path);
+            // The payload starts right after the preamble, which is padded so that the payload offset is aligned.
+            // The bound is checked by subtraction, so that it cannot wrap.
+            if(header.payload_offset() > _mapping->size() || header.byte_size() > _mapping->size() - header.payload_offset())
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
 
-        if(!this->check_magic_string(array_file))
-        {
-            throw npy_array_exception{npy_array_exception_type::invalid_magic_string};
+            _pointer = reinterpret_cast<T*>(_mapping->data() + header.payload_offset());
+            _size = header.size();
         }
 
-        if(!this->check_version(array_file))
+        this->check_for_strides();
+
+        if(mode == npy_array_mode::load_c_order)
         {
-            throw npy_array_exception{npy_array_exception_type::unsupported_version};
+            this->to_c_order(pool ? *pool : npy_thread_pool::shared());
         }
-
-        this->parse_header(this->read_header(array_file));
-
-        _data.resize(multiplies_vector(_shape.cbegin(), _shape.cend()));
-
-        array_file.read(reinterpret_cast<char*>(_data.data()), _data.size() * sizeof(T));
-
-        this->check_for_strides();
     }
     catch(const std::ios_base::failure& failure_exception)
     {
         throw npy_array_exception{npy_array_exception_type::input_output_error};
     }
-    catch(const boost::regex_error& regex_exception)
-    {
-        throw npy_array_exception{npy_array_exception_type::ill_formed_header};
-    }
     catch(const std::bad_alloc& bad_alloc_exception)
     {
         throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
@@ -205,52 +249,55 @@ npy_array<T>::npy_array(const std::string& array_path)
     }
 }
 
-template<typename T>
-npy_array<T>::npy_array(const std::vector<size_t>& shape) 
-    : _shape{shape}, _data{}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(const std::vector<size_t>& shape, const Allocator& allocator)
+    : _shape{shape}, _data(storage_allocator(allocator)), _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
 {
     if(!_dtype)
     {
         throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
     }
     
-    _data.resize(multiplies_vector(_shape.cbegin(), _shape.cend()));
+    _data.resize(multiplies_vector(_shape.cbegin(), _shape.cend()), storage_type());
 
+    this->attach_data();
     this->check_for_strides();
 }
 
-template<typename T>
-npy_array<T>::npy_array(std::vector<size_t>&& shape)
-    : _shape{std::move(shape)}, _data{}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(std::vector<size_t>&& shape, const Allocator& allocator)
+    : _shape{std::move(shape)}, _data(storage_allocator(allocator)), _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
 {
     if(!_dtype)
     {
         throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
     }
     
-    _data.resize(multiplies_vector(_shape.cbegin(), _shape.cend()));
+    _data.resize(multiplies_vector(_shape.cbegin(), _shape.cend()), storage_type());
 
+    this->attach_data();
     this->check_for_strides();
 }
 
-template<class T> 
-npy_array<T>::npy_array(std::initializer_list<size_t> shape_list)
-    : _shape{shape_list}, _data{}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(std::initializer_list<size_t> shape_list, const Allocator& allocator)
+    : _shape{shape_list}, _data(storage_allocator(allocator)), _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
 {
     if(!_dtype)
     {
         throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
     }
     
-    _data.resize(multiplies_vector(shape_list.begin(), shape_list.end()));
+    _data.resize(multiplies_vector(shape_list.begin(), shape_list.end()), storage_type());
 
+    this->attach_data();
     this->check_for_strides();
 }
 
 
-template<typename T>
-npy_array<T>::npy_array(const std::vector<size_t>& shape, const std::vector<T>& data)
-    : _shape{}, _data{}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(const std::vector<size_t>& shape, const std::vector<T>& data)
+    : _shape{}, _data{}, _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
 {
     if(multiplies_vector(shape.cbegin(), shape.cend()) == data.size())
     {
@@ -260,8 +307,9 @@ npy_array<T>::npy_array(const std::vector<size_t>& shape, const std::vector<T>&
         }
         
         _shape = shape;
-        _data = data;
+        _data.assign(data.cbegin(), data.cend());
 
+        this->attach_data();
         this->check_for_strides();
     }
     else
@@ -271,9 +319,9 @@ npy_array<T>::npy_array(const std::vector<size_t>& shape, const std::vector<T>&
     
 } 
 
-template<typename T>
-npy_array<T>::npy_array(std::vector<size_t>&& shape, std::vector<T>&& data)
-    : _shape{}, _data{}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(std::vector<size_t>&& shape, std::vector<T>&& data)
+    : _shape{}, _data{}, _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
 {
     if(multiplies_vector(shape.cbegin(), shape.cend()) == data.size())
     {
@@ -282,9 +330,10 @@ npy_array<T>::npy_array(std::vector<size_t>&& shape, std::vector<T>&& data)
             throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
         }
         
-        _shape = shape;
-        _data = data;
+        _shape = std::move(shape);
+        move_into_storage(_data, _adopted_data, std::move(data), std::integral_constant<bool, std::is_same<Allocator, std::allocator<T>>::value>{});
 
+        this->attach_data();
         this->check_for_strides();
     }
     else
@@ -294,9 +343,9 @@ npy_array<T>::npy_array(std::vector<size_t>&& shape, std::vector<T>&& data)
     
 }
 
-template<class T> 
-npy_array<T>::npy_array(std::initializer_list<size_t> shape_list, std::initializer_list<T> data_list)
-    : _shape{}, _data{}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(std::initializer_list<size_t> shape_list, std::initializer_list<T> data_list)
+    : _shape{}, _data{}, _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{std::move(npy_dtype::from_type<T>())}, _fortran_order{false}
 {
     if(multiplies_vector(shape_list.begin(), shape_list.end()) == data_list.size())
     {
@@ -307,8 +356,9 @@ npy_array<T>::npy_array(std::initializer_list<size_t> shape_list, std::initializ
         
 
         _shape = shape_list;
-        _data = data_list;
+        _data.assign(data_list.begin(), data_list.end());
 
+        this->attach_data();
         this->check_for_strides();
     }
     else
@@ -317,50 +367,109 @@ npy_array<T>::npy_array(std::initializer_list<size_t> shape_list, std::initializ
     }
 }
 
-template<class T> 
-T& npy_array<T>::operator[](size_t index) noexcept
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(const npy_array& other)
+    : _shape{other._shape}, _data(other.cbegin(), other.cend(), std::allocator_traits<storage_allocator>::select_on_container_copy_construction(other._data.get_allocator())), _mapping{}, _pointer{nullptr}, _size{0}, _strides{other._strides}, _dtype{other._dtype}, _fortran_order{other._fortran_order}
+{
+    // A copy always owns its payload, even when the other array refers to a mapping.
+    this->attach_data();
+}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(npy_array&& other) noexcept
+    : _shape{std::move(other._shape)}, _data{std::move(other._data)}, _adopted_data{std::move(other._adopted_data)}, _mapping{std::move(other._mapping)}, _pointer{other._pointer}, _size{other._size}, _strides{std::move(other._strides)}, _dtype{std::move(other._dtype)}, _fortran_order{other._fortran_order}
+{
+    other._pointer = nullptr;
+    other._size = 0;
+    other._fortran_order = false;
+}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator>& npy_array<T, Allocator>::operator=(const npy_array& other)
+{
+    if(this != &other)
+    {
+        _shape = other._shape;
+        _data.assign(other.cbegin(), other.cend());
+        _adopted_data = std::vector<storage_type>{};
+        _mapping.reset();
+        _strides = other._strides;
+        _dtype = other._dtype;
+        _fortran_order = other._fortran_order;
+
+        this->attach_data();
+    }
+
+    return *this;
+}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator>& npy_array<T, Allocator>::operator=(npy_array&& other) noexcept
 {
-    return _data[index];
+    if(this != &other)
+    {
+        _shape = std::move(other._shape);
+        _data = std::move(other._data);
+        _adopted_data = std::move(other._adopted_data);
+        _mapping = std::move(other._mapping);
+        _pointer = other._pointer;
+        _size = other._size;
+        _strides = std::move(other._strides);
+        _dtype = std::move(other._dtype);
+        _fortran_order = other._fortran_order;
+
+        other._pointer = nullptr;
+        other._size = 0;
+        other._fortran_order = false;
+    }
+
+    return *this;
 }
 
-template<class T> 
-const T& npy_array<T>::operator[](size_t index) const noexcept
+template<typename T, typename Allocator>
+T& npy_array<T, Allocator>::operator[](size_t index) noexcept
 {
-    return _data[index];
+    return _pointer[index];
 }
 
-template<class T> 
-T& npy_array<T>::operator[](std::initializer_list<size_t> indexes) noexcept
+template<typename T, typename Allocator>
+const T& npy_array<T, Allocator>::operator[](size_t index) const noexcept
+{
+    return _pointer[index];
+}
+
+template<typename T, typename Allocator>
+T& npy_array<T, Allocator>::operator[](std::initializer_list<size_t> indexes) noexcept
 {
     size_t index = std::inner_product(indexes.begin(), indexes.end(), _strides.begin(), size_t(0));
 
-    return _data[index];
+    return _pointer[index];
 }
 
-template<class T> 
-const T& npy_array<T>::operator[](std::initializer_list<size_t> indexes) const noexcept
+template<typename T, typename Allocator>
+const T& npy_array<T, Allocator>::operator[](std::initializer_list<size_t> indexes) const noexcept
 {
     size_t index = std::inner_product(indexes.begin(), indexes.end(), _strides.begin(), size_t(0));
 
-    return _data[index];
+    return _pointer[index];
 }
 
-template<class T> 
-T& npy_array<T>::at(size_t index)
+template<typename T, typename Allocator>
+T& npy_array<T, Allocator>::at(size_t index)
 {
-    if(index >= _data.size()) throw std::out_of_range{"Index " + std::to_string(index) + " is out of range " + std::to_string(_data.size())};
-    return _data[index];
+    if(index >= _size) throw std::out_of_range{"Index " + std::to_string(index) + " is out of range " + std::to_string(_size)};
+    return _pointer[index];
 }
 
-template<class T> 
-const T& npy_array<T>::at(size_t index) const
+template<typename T, typename Allocator>
+const T& npy_array<T, Allocator>::at(size_t index) const
 {
-    if(index >= _data.size()) throw std::out_of_range{"Index " + std::to_string(index) + " is out of range " + std::to_string(_data.size())};
-    return _data[index];
+    if(index >= _size) throw std::out_of_range{"Index " + std::to_string(index) + " is out of range " + std::to_string(_size)};
+    return _pointer[index];
 }
 
-template<class T> 
-T& npy_array<T>::at(std::initializer_list<size_t> indexes)
+template<typename T, typename Allocator>
+T& npy_array<T, Allocator>::at(std::initializer_list<size_t> indexes)
 {
     if(indexes.size() != _shape.size()) throw std::out_of_range{"The number of provided indexes " + std::to_string(indexes.size()) + " does not match the number of dimensions " + std::to_string(_shape.size())};
 
@@ -369,15 +478,13 @@ T& npy_array<T>::at(std::initializer_list<size_t> indexes)
         if(*(indexes.begin() + i) >= _shape[i]) throw std::out_of_range{"The dimensions provided " + std::to_string(*(indexes.begin() + i)) + " at index " + std::to_string(i) + " does not match the dimension " + std::to_string(_shape[i]) + " at index " + std::to_string(i)};
     }
 
-    this->check_for_strides();
-
     size_t index = std::inner_product(indexes.begin(), indexes.end(), _strides.begin(), size_t(0));
 
-    return _data[index];
+    return _pointer[index];
 }
 
-template<class T> 
-const T& npy_array<T>::at(std::initializer_list<size_t> indexes) const
+template<typename T, typename Allocator>
+const T& npy_array<T, Allocator>::at(std::initializer_list<size_t> indexes) const
 {
     if(indexes.size() != _shape.size()) throw std::out_of_range{"The number of provided indexes " + std::to_string(indexes.size()) + " does not match the number of dimensions " + std::to_string(_shape.size())};
 
@@ -386,66 +493,533 @@ const T& npy_array<T>::at(std::initializer_list<size_t> indexes) const
         if(*(indexes.begin() + i) >= _shape[i]) throw std::out_of_range{"The dimensions provided " + std::to_string(*(indexes.begin() + i)) + " at index " + std::to_string(i) + " does not match the dimension " + std::to_string(_shape[i]) + " at index " + std::to_string(i)};
     }
 
+    size_t index = std::inner_product(indexes.begin(), indexes.end(), _strides.begin(), size_t(0));
+
+    return _pointer[index];
+}
+
+template<typename T, typename Allocator> T* npy_array<T, Allocator>::begin() noexcept {return _pointer;}
+template<typename T, typename Allocator> const T* npy_array<T, Allocator>::begin() const noexcept {return _pointer;}
+template<typename T, typename Allocator> const T* npy_array<T, Allocator>::cbegin() const noexcept {return _pointer;}
+
+template<typename T, typename Allocator> T* npy_array<T, Allocator>::end() noexcept {return _pointer + _size;}
+template<typename T, typename Allocator> const T* npy_array<T, Allocator>::end() const noexcept {return _pointer + _size;}
+template<typename T, typename Allocator> const T* npy_array<T, Allocator>::cend() const noexcept {return _pointer + _size;}
+
+template<typename T, typename Allocator>
+template<typename... Indexes>
+T& npy_array<T, Allocator>::operator()(Indexes... indexes) noexcept
+{
+    // The leading zero keeps the list valid without indexes.
+    const size_t values[] = {0, static_cast<size_t>(indexes)...};
+    const size_t* strides = _strides.data();
+    size_t index = 0;
+
+    assert(sizeof...(Indexes) == _shape.size());
+
+    for(size_t i = 0; i < sizeof...(Indexes); i++)
+    {
+        index += values[i + 1] * strides[i];
+    }
+
+    return _pointer[index];
+}
+
+template<typename T, typename Allocator>
+template<typename... Indexes>
+const T& npy_array<T, Allocator>::operator()(Indexes... indexes) const noexcept
+{
+    return const_cast<npy_array&>(*this)(indexes...);
+}
+
+template<typename T, typename Allocator>
+template<typename... Indexes, typename>
+T& npy_array<T, Allocator>::at(Indexes... indexes)
+{
+    const size_t values[] = {0, static_cast<size_t>(indexes)...};
+
+    if(sizeof...(Indexes) != _shape.size()) throw std::out_of_range{"The number of provided indexes " + std::to_string(sizeof...(Indexes)) + " does not match the number of dimensions " + std::to_string(_shape.size())};
+
+    for(size_t i = 0; i < sizeof...(Indexes); i++)
+    {
+        if(values[i + 1] >= _shape[i]) throw std::out_of_range{"Index " + std::to_string(values[i + 1]) + " is out of range " + std::to_string(_shape[i]) + " of the dimension " + std::to_string(i)};
+    }
+
+    return (*this)(indexes...);
+}
+
+template<typename T, typename Allocator>
+template<typename... Indexes, typename>
+const T& npy_array<T, Allocator>::at(Indexes... indexes) const
+{
+    return const_cast<npy_array&>(*this).at(indexes...);
+}
+
+template<typename T, typename Allocator>
+template<size_t N>
+npy_accessor<T, N> npy_array<T, Allocator>::accessor()
+{
+    if(_shape.size() != N) throw std::invalid_argument{"An accessor of " + std::to_string(N) + " dimensions does not match the number of dimensions " + std::to_string(_shape.size())};
+
+    std::array<size_t, N> shape;
+    std::array<size_t, N> strides;
+    std::copy(_shape.cbegin(), _shape.cend(), shape.begin());
+    std::copy(_strides.cbegin(), _strides.cend(), strides.begin());
+
+    return npy_accessor<T, N>{_pointer, shape, strides};
+}
+
+template<typename T, typename Allocator>
+template<size_t N>
+npy_accessor<const T, N> npy_array<T, Allocator>::accessor() const
+{
+    npy_accessor<T, N> mutable_accessor = const_cast<npy_array&>(*this).template accessor<N>();
+
+    return npy_accessor<const T, N>{mutable_accessor.data(), mutable_accessor.shape(), mutable_accessor.strides()};
+}
+
+template<typename T, typename Allocator> const std::vector<size_t>& npy_array<T, Allocator>::shape() const noexcept {return _shape;}
+template<typename T, typename Allocator> const npy_dtype &npy_array<T, Allocator>::dtype() const noexcept {return _dtype;}
+template<typename T, typename Allocator> Allocator npy_array<T, Allocator>::get_allocator() const {return Allocator(_data.get_allocator());}
+template<typename T, typename Allocator> bool npy_array<T, Allocator>::fortran_order() const noexcept {return _fortran_order;}
+template<typename T, typename Allocator> bool npy_array<T, Allocator>::mapped() const noexcept {return static_cast<bool>(_mapping);}
+
+template<typename T, typename Allocator> const T *npy_array<T, Allocator>::data() const noexcept {return _pointer;}
+template<typename T, typename Allocator> T *npy_array<T, Allocator>::data() noexcept {return _pointer;}
+
+template<typename T, typename Allocator> size_t npy_array<T, Allocator>::size() const noexcept {return _size;}
+template<typename T, typename Allocator> size_t npy_array<T, Allocator>::byte_size() const noexcept {return _size * sizeof(T);}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(const std::vector<size_type>& shape, bool fortran_order, std::shared_ptr<npy_mapping> mapping, size_type payload_offset,
+                                   const Allocator& allocator)
+    : _shape{shape}, _data(storage_allocator(allocator)), _mapping{std::move(mapping)}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{npy_dtype::from_type<T>()}, _fortran_order{fortran_order}
+{
+    _pointer = reinterpret_cast<T*>(_mapping->data() + payload_offset);
+    _size = multiplies_vector(_shape.cbegin(), _shape.cend());
+
     this->check_for_strides();
+}
 
-    size_t index = std::inner_product(indexes.begin(), indexes.end(), _strides.begin(), size_t(0));
+template<typename T, typename Allocator>
+npy_array<T, Allocator>::npy_array(const std::vector<size_t>& shape, const Allocator& allocator, uninitialized_payload)
+    : _shape{shape}, _data(storage_allocator(allocator)), _mapping{}, _pointer{nullptr}, _size{0}, _strides{}, _dtype{npy_dtype::from_type<T>()}, _fortran_order{false}
+{
+    if(!_dtype)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+    }
+
+    try
+    {
+        _data.resize(multiplies_vector(_shape.cbegin(), _shape.cend()));
+    }
+    catch(const std::bad_alloc& bad_alloc_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+    }
+
+    this->attach_data();
+    this->check_for_strides();
+}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator> npy_array<T, Allocator>::uninitialized(const std::vector<size_type>& shape, const Allocator& allocator)
+{
+    return npy_array{shape, allocator, uninitialized_payload{}};
+}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator> npy_array<T, Allocator>::create_mapped(const std::string& array_path, const std::vector<size_type>& shape)
+{
+    if(!npy_dtype::from_type<T>())
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+    }
+
+    npy_header header{npy_dtype::from_type<T>(), false, shape};
+    std::string preamble = header.str();
+
+    // The header is written up front, the payload is left to the file system which fills it with zeros.
+    std::shared_ptr<npy_mapping> mapping = npy_mapping::create(array_path, preamble.size() + header.byte_size());
+    std::copy(preamble.cbegin(), preamble.cend(), mapping->data());
+
+    return npy_array{shape, false, std::move(mapping), preamble.size()};
+}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator> npy_array<T, Allocator>::load_converted(const std::string& array_path, npy_cast cast, const Allocator& allocator)
+{
+    std::ifstream array_file{};
+
+    array_file.exceptions(std::ifstream::failbit | std::ifstream::badbit | std::ifstream::eofbit);
+
+    try
+    {
+        array_file.open(array_path);
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    npy_header header = npy_header::read(array_file);
+    const npy_dtype& file_dtype = header.dtype();
+
+    if(file_dtype.with_byte_order(npy_endianness::native) == npy_dtype::from_type<T>())
+    {
+        return npy_array{array_file, array_path, header, npy_array_mode::load_in_memory, allocator};
+    }
+
+    if(!npy_convertible<T>(file_dtype))
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+    }
+
+    try
+    {
+        npy_array array = npy_array::uninitialized(header.shape(), allocator);
+        array._fortran_order = header.fortran_order();
+        array._strides.clear();
+        array.check_for_strides();
+
+        // Each chunk is converted right after being read, while it is still in cache.
+        const size_type item_size = file_dtype.item_size();
+        const size_type chunk_size = std::max(size_type(1), swap_chunk_byte_size / item_size);
+        const bool swap_bytes = file_dtype != file_dtype.with_byte_order(npy_endianness::native);
+        std::vector<char> buffer(std::min(chunk_size, array._size) * item_size);
+
+        for(size_type offset = 0; offset < array._size; offset += chunk_size)
+        {
+            size_type count = std::min(chunk_size, array._size - offset);
+            array_file.read(buffer.data(), count * item_size);
+
+            if(swap_bytes)
+            {
+                npy_byteswap(buffer.data(), count, file_dtype);
+            }
+
+            npy_convert(buffer.data(), file_dtype, array._pointer + offset, count, cast);
+        }
+
+        return array;
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+    catch(const std::bad_alloc& bad_alloc_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+    }
+}
+
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::sync(bool asynchronous)
+{
+    if(_mapping)
+    {
+        _mapping->sync(asynchronous);
+    }
+}
+
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::save(const std::string &array_path, npy_endianness byte_order) const
+{
+    npy_save_options options{};
+    options.byte_order = byte_order;
+
+    this->save(array_path, options);
+}
+
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::save(const std::string& array_path, const npy_save_options& options) const
+{
+    const npy_dtype saved_dtype = _dtype.with_byte_order(options.byte_order);
+    const npy_header header{saved_dtype, _fortran_order, _shape};
+
+    // The preambles of the usual shapes are formatted on the stack.
+    char stack_preamble[preamble_stack_size];
+    std::string heap_preamble{};
+    const char* preamble = stack_preamble;
+    const size_type preamble_size = header.write_preamble(stack_preamble, sizeof(stack_preamble));
+
+    if(preamble_size > sizeof(stack_preamble))
+    {
+        heap_preamble = header.str();
+        preamble = heap_preamble.data();
+    }
+
+    std::function<void(char*, size_t)> swap{};
+
+    if(saved_dtype != _dtype)
+    {
+        swap = [&saved_dtype](char* bytes, size_t length)
+        {
+            npy_byteswap(bytes, length / sizeof(T), saved_dtype);
+        };
+    }
+
+    const char* payload = reinterpret_cast<const char*>(_pointer);
+    npy_thread_pool& pool = options.pool ? *options.pool : npy_thread_pool::shared();
+
+    // An atomic save writes a file next to the destination and then renames it, so a failed save never leaves a truncated file.
+    // The destination is the target of a symbolic link, and a destination that is not a regular file is written in place.
+    const std::string commit_path = options.atomic ? npy_commit_path(array_path) : array_path;
+    const bool atomic = options.atomic && !commit_path.empty();
+    const std::string destination_path = atomic ? commit_path : array_path;
+    const std::string file_path = atomic ? npy_temporary_path(destination_path) : destination_path;
+
+    try
+    {
+        if(options.direct)
+        {
+            // The chunks of the file are filled with the part of the preamble and of the payload they cover.
+            // The preamble size is a multiple of 64, so the payload is split at element boundaries.
+            // The pages of a payload placed in memory like in the file, like the one loaded with load_direct, are written straight from it.
+            npy_direct_write(file_path, preamble_size + this->byte_size(), [&](uint64_t offset, char* buffer, size_t length)
+            {
+                if(offset < preamble_size)
+                {
+                    size_t preamble_length = std::min<size_t>(length, preamble_size - offset);
+                    std::memcpy(buffer, preamble + offset, preamble_length);
+
+                    offset += preamble_length;
+                    buffer += preamble_length;
+                    length -= preamble_length;
+                }
+
+                std::memcpy(buffer, payload + (offset - preamble_size), length);
+
+                if(swap)
+                {
+                    swap(buffer, length);
+                }
+            }, pool, npy_direct_chunk_size, swap ? nullptr : payload, preamble_size);
+        }
+        else if(options.parallel)
+        {
+            npy_parallel_write(file_path, std::string(preamble, preamble_size), payload, this->byte_size(), pool, npy_parallel_chunk_size, swap);
+        }
+        else
+        {
+            npy_write_file(file_path, preamble, preamble_size, payload, this->byte_size(), swap);
+        }
+
+        npy_commit_file(file_path, destination_path, options.sync);
+    }
+    catch(...)
+    {
+        if(atomic)
+        {
+            std::remove(file_path.c_str());
+        }
+
+        throw;
+    }
+}
 
-    return _data[index];
+template<typename T, typename Allocator>
+npy_header npy_array<T, Allocator>::probe_rows(const std::string& array_path)
+{
+    npy_header header = npy_header::probe(array_path);
+
+    if(header.dtype().with_byte_order(npy_endianness::native) != npy_dtype::from_type<T>())
+    {
+        throw npy_array_exception{npy_array_exception_type::ill_formed_header};
+    }
+
+    // The rows of a Fortran-ordered payload are scattered, a 0-d array has none.
+    if(header.fortran_order() || header.shape().empty())
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_layout};
+    }
+
+    return header;
 }
 
-template<class T> T* npy_array<T>::begin() noexcept {return _data.data();}
-template<class T> const T* npy_array<T>::begin() const noexcept {return _data.data();}
-template<class T> const T* npy_array<T>::cbegin() const noexcept {return _data.data();}
+template<typename T, typename Allocator>
+npy_array<T, Allocator> npy_array<T, Allocator>::load_rows(const std::string& array_path, size_type first_row, size_type row_count, npy_thread_pool& pool,
+                                                            const Allocator& allocator)
+{
+    const npy_header header = probe_rows(array_path);
+
+    if(first_row > header.shape()[0] || row_count > header.shape()[0] - first_row)
+    {
+        throw std::out_of_range{"The rows from " + std::to_string(first_row) + " to " + std::to_string(first_row + row_count) + " are out of range " + std::to_string(header.shape()[0])};
+    }
 
-template<class T> T* npy_array<T>::end() noexcept {return _data.data() + _data.size();}
-template<class T> const T* npy_array<T>::end() const noexcept {return _data.data() + _data.size();}
-template<class T> const T* npy_array<T>::cend() const noexcept {return _data.data() + _data.size();}
+    std::vector<size_type> shape{header.shape()};
+    shape[0] = row_count;
 
-template<class T> const std::vector<size_t>& npy_array<T>::shape() const noexcept {return _shape;}
-template<class T> const npy_dtype &npy_array<T>::dtype() const noexcept {return _dtype;}
-template<class T> bool npy_array<T>::fortran_order() const noexcept {return _fortran_order;}
+    npy_array array = npy_array::uninitialized(shape, allocator);
+    const size_type row_size = std::accumulate(shape.cbegin() + 1, shape.cend(), sizeof(T), std::multiplies<size_type>());
 
-template<class T> const T *npy_array<T>::data() const noexcept {return _data.data();}
-template<class T> T *npy_array<T>::data() noexcept {return _data.data();}
+    std::function<void(char*, size_t)> swap{};
 
-template<typename T> size_t npy_array<T>::size() const noexcept {return _data.size();}
-template<typename T> size_t npy_array<T>::byte_size() const noexcept {return _data.size() * sizeof(T);}
+    if(header.dtype() != npy_dtype::from_type<T>())
+    {
+        const npy_dtype file_dtype = header.dtype();
 
-template<class T> 
-void npy_array<T>::save(const std::string &array_path)
+        swap = [file_dtype](char* bytes, size_t length)
+        {
+            npy_byteswap(bytes, length / sizeof(T), file_dtype);
+        };
+    }
+
+    npy_parallel_read(array_path, header.payload_offset() + first_row * row_size, reinterpret_cast<char*>(array.data()), array.byte_size(),
+                      pool, npy_parallel_chunk_size, swap);
+
+    return array;
+}
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator> npy_array<T, Allocator>::load_rows(const std::string& array_path, const std::vector<size_type>& rows, npy_thread_pool& pool,
+                                                            const Allocator& allocator)
 {
-    std::stringstream header_string{};
-    header_string << "{'descr': '" << _dtype.str() << "', 'fortran_order': ";
-    header_string << (_fortran_order ? "True" : "False");
-    header_string << ", 'shape': (";
+    const npy_header header = probe_rows(array_path);
+
+    std::vector<size_type> shape{header.shape()};
+    shape[0] = rows.size();
+
+    npy_array array = npy_array::uninitialized(shape, allocator);
+    const size_type row_size = std::accumulate(shape.cbegin() + 1, shape.cend(), sizeof(T), std::multiplies<size_type>());
+    char* destination = reinterpret_cast<char*>(array.data());
+
+    if(rows.empty()) return array;
+
+    // The positions of the rows in the array, sorted by their index in the file.
+    std::vector<size_type> positions(rows.size());
+    std::iota(positions.begin(), positions.end(), size_type(0));
+    std::sort(positions.begin(), positions.end(), [&rows](size_type left, size_type right) {return rows[left] < rows[right];});
+
+    if(rows[positions.back()] >= header.shape()[0])
+    {
+        throw std::out_of_range{"The row " + std::to_string(rows[positions.back()]) + " is out of range " + std::to_string(header.shape()[0])};
+    }
+
+    if(row_size == 0) return array;
+
+    // A repeated row is read once, then copied from its first position.
+    std::vector<std::pair<size_type, size_type>> repeated_rows{};
+    size_type unique = 1;
+
+    for(size_type i = 1; i < positions.size(); i++)
+    {
+        if(rows[positions[i]] == rows[positions[unique - 1]])
+        {
+            repeated_rows.emplace_back(positions[i], positions[unique - 1]);
+        }
+        else
+        {
+            positions[unique++] = positions[i];
+        }
+    }
+
+    positions.resize(unique);
+
+    // A run of adjacent rows is read with one request, straight into the array when the rows are adjacent in the array too,
+    // otherwise into a buffer from which they are copied to their positions.
+    struct buffered_run {size_type begin; size_type end; size_type buffer_row;};
+
+    std::vector<npy_read_request> requests{};
+    std::vector<buffered_run> buffered_runs{};
+    size_type buffer_rows = 0;
+
+    for(size_type begin = 0, end = 0; begin < positions.size(); begin = end)
+    {
+        bool in_place = true;
+
+        for(end = begin + 1; end < positions.size() && rows[positions[end]] == rows[positions[end - 1]] + 1; end++)
+        {
+            in_place = in_place && positions[end] == positions[end - 1] + 1;
+        }
+
+        const uint64_t offset = header.payload_offset() + rows[positions[begin]] * row_size;
+        const size_type length = (end - begin) * row_size;
+
+        if(in_place)
+        {
+            requests.push_back(npy_read_request{offset, length, destination + positions[begin] * row_size});
+        }
+        else
+        {
+            // The destination is set once the buffer is allocated.
+            requests.push_back(npy_read_request{offset, length, nullptr});
+            buffered_runs.push_back(buffered_run{begin, end, buffer_rows});
+            buffer_rows += end - begin;
+        }
+    }
+
+    std::unique_ptr<char[]> buffer{buffer_rows > 0 ? new char[buffer_rows * row_size] : nullptr};
 
-    for(size_type i = 0; i != _shape.size() - 1; i++)
+    for(size_type i = 0, run = 0; i < requests.size(); i++)
     {
-        header_string << _shape[i] << ", ";
+        if(requests[i].destination == nullptr)
+        {
+            requests[i].destination = buffer.get() + buffered_runs[run++].buffer_row * row_size;
+        }
     }
 
-    header_string << *(_shape.cend() - 1) << "), }";
+    npy_gather_read(array_path, requests, pool);
 
-    size_type header_size = 6 + 2 + 2 + header_string.str().size() + 1;
-    size_type padding = 64 - (header_size % 64);
+    for(const buffered_run& run : buffered_runs)
+    {
+        const char* source = buffer.get() + run.buffer_row * row_size;
 
-    if(padding > 0)
+        for(size_type i = run.begin; i < run.end; i++, source += row_size)
+        {
+            std::memcpy(destination + positions[i] * row_size, source, row_size);
+        }
+    }
+
+    for(const auto& repeated_row : repeated_rows)
     {
-        header_string << std::string(padding, '\x20');
-        header_string << '\n';
-        header_size += padding;
+        std::memcpy(destination + repeated_row.first * row_size, destination + repeated_row.second * row_size, row_size);
     }
 
-    header_size = header_string.str().size();
+    if(header.dtype() != npy_dtype::from_type<T>())
+    {
+        npy_byteswap(array.data(), array.size(), header.dtype());
+    }
+
+    return array;
+}
+
+template<typename T, typename Allocator>
+std::future<npy_array<T, Allocator>> npy_array<T, Allocator>::async_load(const std::string& array_path, npy_array_mode mode, npy_thread_pool& pool, const Allocator& allocator)
+{
+    return pool.submit([array_path, mode, allocator]()
+    {
+        return npy_array<T, Allocator>{array_path, mode, allocator};
+    });
+}
 
-    std::ofstream array_stream{array_path, std::ios_base::out | std::ios_base::binary};
-    array_stream << "\x93NUMPY";
-    array_stream << uint8_t(0x01) << uint8_t(0x00);
-    array_stream.write(reinterpret_cast<const char*>(&header_size), sizeof(uint16_t));
-    array_stream << header_string.str();
-    array_stream.write(reinterpret_cast<const char*>(_data.data()), this->byte_size());
-    array_stream.flush();
+template<typename T, typename Allocator>
+std::future<void> npy_array<T, Allocator>::async_save(const std::string& array_path, npy_endianness byte_order, npy_thread_pool& pool) const
+{
+    return pool.submit([this, array_path, byte_order]()
+    {
+        this->save(array_path, byte_order);
+    });
 }
 
+template<typename T, typename Allocator>
+void npy_array<T, Allocator>::to_c_order(npy_thread_pool& pool)
+{
+    if(!_fortran_order) return;
+
+    storage_vector c_data(_data.get_allocator());
+    c_data.resize(_size);
+    npy_fortran_to_c_order(_pointer, reinterpret_cast<T*>(c_data.data()), _shape, pool);
+
+    _data = std::move(c_data);
+    _adopted_data = std::vector<storage_type>{};
+    _mapping.reset();
+    _fortran_order = false;
 
+    this->attach_data();
 
+    _strides.clear();
+    this->check_for_strides();
+}
@@ -0,0 +1,32 @@
+#include "npy_array/npy_batch.h"
+
+std::vector<npy_probe_item> npy_probe_batch(const std::vector<std::string>& paths, npy_thread_pool& pool)
+{
+    std::vector<npy_probe_item> items(paths.size(), npy_probe_item{npy_header{}, false, npy_array_exception_type::generic});
+
+    pool.parallel_for(0, paths.size(), [&](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            try
+            {
+                items[i].header = npy_header::probe(paths[i]);
+                items[i].probed = true;
+            }
+            catch(const npy_array_exception& exception)
+            {
+                items[i].error = exception.exception_type();
+            }
+            catch(const std::bad_alloc& bad_alloc_exception)
+            {
+                items[i].error = npy_array_exception_type::unsufficient_memory;
+            }
+            catch(...)
+            {
+                items[i].error = npy_array_exception_type::generic;
+            }
+        }
+    });
+
+    return items;
+}
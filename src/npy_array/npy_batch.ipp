@@ -0,0 +1,167 @@
+#include "npy_array/npy_batch.h"
+
+#include <stdexcept>
+
+// Open an array file and read its header, leaving the stream positioned at the payload.
+inline npy_header npy_batch_open(std::ifstream& array_file, const std::string& array_path)
+{
+    array_file.exceptions(std::ifstream::failbit | std::ifstream::badbit | std::ifstream::eofbit);
+
+    try
+    {
+        array_file.open(array_path);
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    return npy_header::read(array_file);
+}
+
+template<typename T>
+std::vector<npy_batch_item<T>> npy_load_batch(const std::vector<std::string>& paths, npy_array_mode mode, npy_thread_pool& pool)
+{
+    std::vector<npy_batch_item<T>> items(paths.size());
+
+    // The transposes run on the pool too, so they cannot be started by its tasks.
+    const npy_array_mode file_mode = mode == npy_array_mode::load_c_order ? npy_array_mode::load_in_memory : mode;
+
+    pool.parallel_for(0, paths.size(), [&](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            try
+            {
+                items[i].array.reset(new npy_array<T>{paths[i], file_mode});
+            }
+            catch(const npy_array_exception& exception)
+            {
+                items[i].error = exception.exception_type();
+            }
+            catch(const std::bad_alloc& bad_alloc_exception)
+            {
+                items[i].error = npy_array_exception_type::unsufficient_memory;
+            }
+            catch(...)
+            {
+                items[i].error = npy_array_exception_type::generic;
+            }
+        }
+    });
+
+    if(mode == npy_array_mode::load_c_order)
+    {
+        for(auto& item : items)
+        {
+            if(item.array) item.array->to_c_order(pool);
+        }
+    }
+
+    return items;
+}
+
+template<typename T>
+npy_array<T> npy_load_stacked(const std::vector<std::string>& paths, npy_thread_pool& pool)
+{
+    typedef typename npy_array<T>::size_type size_type;
+
+    if(paths.empty())
+    {
+        throw std::invalid_argument{"npy_load_stacked requires at least one path"};
+    }
+
+    // The first file gives the shape of the slots, its header is read again by its task.
+    std::vector<size_type> file_shape{};
+
+    {
+        std::ifstream first_file{};
+        file_shape = npy_batch_open(first_file, paths.front()).shape();
+    }
+
+    std::vector<size_type> stacked_shape{paths.size()};
+    stacked_shape.insert(stacked_shape.end(), file_shape.cbegin(), file_shape.cend());
+
+    npy_array<T> stacked = npy_array<T>::uninitialized(stacked_shape);
+
+    const size_type slot_size = stacked.size() / paths.size();
+    const npy_dtype dtype = npy_dtype::from_type<T>();
+
+    std::vector<npy_array_exception_type> errors(paths.size(), npy_array_exception_type::generic);
+    std::vector<uint8_t> failed(paths.size(), 0);
+    std::vector<uint8_t> fortran_order(paths.size(), 0);
+
+    pool.parallel_for(0, paths.size(), [&](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            try
+            {
+                std::ifstream array_file{};
+                npy_header header = npy_batch_open(array_file, paths[i]);
+
+                if(header.dtype().with_byte_order(npy_endianness::native) != dtype)
+                {
+                    throw npy_array_exception{npy_array_exception_type::ill_formed_header};
+                }
+
+                if(header.shape() != file_shape)
+                {
+                    throw npy_array_exception{npy_array_exception_type::unmatched_shape_data};
+                }
+
+                T* slot = stacked.data() + i * slot_size;
+
+                try
+                {
+                    array_file.read(reinterpret_cast<char*>(slot), slot_size * sizeof(T));
+                }
+                catch(const std::ios_base::failure& failure_exception)
+                {
+                    throw npy_array_exception{npy_array_exception_type::input_output_error};
+                }
+
+                if(header.dtype() != dtype)
+                {
+                    npy_byteswap(slot, slot_size, header.dtype());
+                }
+
+                fortran_order[i] = header.fortran_order();
+            }
+            catch(const npy_array_exception& exception)
+            {
+                errors[i] = exception.exception_type();
+                failed[i] = 1;
+            }
+            catch(...)
+            {
+                failed[i] = 1;
+            }
+        }
+    });
+
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        if(failed[i])
+        {
+            throw npy_array_exception{errors[i]};
+        }
+    }
+
+    // Each Fortran-ordered slot is transposed in place through a buffer, by the whole pool.
+    std::unique_ptr<T[]> fortran_slot{};
+
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        if(fortran_order[i] && file_shape.size() >= 2)
+        {
+            if(!fortran_slot) fortran_slot.reset(new T[slot_size]);
+
+            T* slot = stacked.data() + i * slot_size;
+            std::copy(slot, slot + slot_size, fortran_slot.get());
+            npy_fortran_to_c_order(fortran_slot.get(), slot, file_shape, pool);
+        }
+    }
+
+    return stacked;
+}
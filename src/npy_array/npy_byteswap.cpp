@@ -0,0 +1,115 @@
+#include "npy_array/npy_byteswap.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Scalar swap of the units in [data, data + count * unit_size), used for the tails of the vectorized loops.
+    void byteswap_scalar(char* data, size_t count, size_t unit_size) noexcept
+    {
+        for(size_t i = 0; i < count; i++, data += unit_size)
+        {
+            switch(unit_size)
+            {
+            case 2:
+            {
+                uint16_t value;
+                std::memcpy(&value, data, 2);
+                value = __builtin_bswap16(value);
+                std::memcpy(data, &value, 2);
+                break;
+            }
+            case 4:
+            {
+                uint32_t value;
+                std::memcpy(&value, data, 4);
+                value = __builtin_bswap32(value);
+                std::memcpy(data, &value, 4);
+                break;
+            }
+            case 8:
+            {
+                uint64_t value;
+                std::memcpy(&value, data, 8);
+                value = __builtin_bswap64(value);
+                std::memcpy(data, &value, 8);
+                break;
+            }
+            default:
+                for(size_t j = 0; j < unit_size / 2; j++)
+                {
+                    std::swap(data[j], data[unit_size - 1 - j]);
+                }
+                break;
+            }
+        }
+    }
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+    // The shuffle mask reversing every unit of a 16 bytes lane, unit_size must divide 16.
+    __m128i lane_mask(size_t unit_size) noexcept
+    {
+        alignas(16) int8_t mask[16];
+
+        for(size_t i = 0; i < 16; i++)
+        {
+            size_t unit_start = i / unit_size * unit_size;
+            mask[i] = static_cast<int8_t>(unit_start + unit_size - 1 - (i - unit_start));
+        }
+
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+    }
+#endif
+}
+
+void npy_byteswap(void* data, size_t count, size_t unit_size) noexcept
+{
+    if(unit_size < 2) return;
+
+    char* bytes = static_cast<char*>(data);
+    size_t byte_size = count * unit_size;
+    size_t swapped = 0;
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+    if(unit_size <= 16 && 16 % unit_size == 0)
+    {
+        __m128i mask = lane_mask(unit_size);
+
+#if defined(__AVX2__)
+        // The AVX2 shuffle works on two independent 16 bytes lanes, the same mask is used for both.
+        __m256i wide_mask = _mm256_broadcastsi128_si256(mask);
+
+        for(; swapped + 32 <= byte_size; swapped += 32)
+        {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + swapped));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes + swapped), _mm256_shuffle_epi8(chunk, wide_mask));
+        }
+#endif
+        for(; swapped + 16 <= byte_size; swapped += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + swapped));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + swapped), _mm_shuffle_epi8(chunk, mask));
+        }
+    }
+#endif
+
+    byteswap_scalar(bytes + swapped, (byte_size - swapped) / unit_size, unit_size);
+}
+
+void npy_byteswap(void* data, size_t count, const npy_dtype& dtype) noexcept
+{
+    if(dtype.kind() == npy_dtype_kind::complex)
+    {
+        npy_byteswap(data, count * 2, dtype.item_size() / 2);
+    }
+    else
+    {
+        npy_byteswap(data, count, dtype.item_size());
+    }
+}
@@ -0,0 +1,101 @@
+#include "npy_array/npy_convert.h"
+
+#include <cstring>
+
+#if defined(__F16C__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    float half_to_float(uint16_t half) noexcept
+    {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+        const uint32_t exponent = (half >> 10) & 0x1F;
+        const uint32_t mantissa = half & 0x3FF;
+        uint32_t bits;
+
+        if(exponent == 0)
+        {
+            // Zero and subnormal values are mantissa * 2^-24, which is exact in float.
+            float value = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+            return sign != 0 ? -value : value;
+        }
+        else if(exponent == 0x1F)
+        {
+            // Infinities and NaN, the payload of NaN is preserved.
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        }
+        else
+        {
+            // Rebias the exponent from 15 to 127.
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+void npy_half_to_float(const uint16_t* source, float* destination, size_t count) noexcept
+{
+    size_t i = 0;
+
+#if defined(__F16C__)
+    for(; i + 8 <= count; i += 8)
+    {
+        __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(half));
+    }
+#endif
+
+    for(; i < count; i++)
+    {
+        destination[i] = half_to_float(source[i]);
+    }
+}
+
+void npy_double_to_float(const double* source, float* destination, size_t count, bool saturate) noexcept
+{
+    const double lowest = static_cast<double>(std::numeric_limits<float>::lowest());
+    const double highest = static_cast<double>(std::numeric_limits<float>::max());
+    size_t i = 0;
+
+#if defined(__AVX__)
+    if(saturate)
+    {
+        const __m256d lowest_vector = _mm256_set1_pd(lowest);
+        const __m256d highest_vector = _mm256_set1_pd(highest);
+
+        for(; i + 4 <= count; i += 4)
+        {
+            __m256d value = _mm256_loadu_pd(source + i);
+            // MAXPD and MINPD return their second operand when either is NaN, so NaN goes through.
+            // Infinities are clamped as well, so they are restored by a blend.
+            __m256d clamped = _mm256_min_pd(highest_vector, _mm256_max_pd(lowest_vector, value));
+            __m256d infinite = _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), value), _mm256_set1_pd(std::numeric_limits<double>::infinity()), _CMP_EQ_OQ);
+            _mm_storeu_ps(destination + i, _mm256_cvtpd_ps(_mm256_blendv_pd(clamped, value, infinite)));
+        }
+    }
+    else
+    {
+        for(; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(destination + i, _mm256_cvtpd_ps(_mm256_loadu_pd(source + i)));
+        }
+    }
+#endif
+
+    for(; i < count; i++)
+    {
+        double value = source[i];
+
+        if(saturate && std::isfinite(value))
+        {
+            value = std::min(std::max(value, lowest), highest);
+        }
+
+        destination[i] = static_cast<float>(value);
+    }
+}
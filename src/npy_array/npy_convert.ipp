@@ -0,0 +1,174 @@
+#include "npy_array/npy_convert.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The number of half precision values widened to float at once before being converted to another type.
+const size_t half_block_size = 1024;
+
+template<typename T> struct npy_is_complex : std::false_type {};
+template<typename T> struct npy_is_complex<std::complex<T>> : std::true_type {};
+
+// Saturating conversions between arithmetic types, bool excluded as destination.
+
+template<typename D, typename S>
+typename std::enable_if<std::is_same<S, bool>::value, D>::type npy_saturate_cast(S value) noexcept
+{
+    return static_cast<D>(value);
+}
+
+template<typename D, typename S>
+typename std::enable_if<std::is_integral<D>::value && std::is_floating_point<S>::value, D>::type npy_saturate_cast(S value) noexcept
+{
+    if(std::isnan(value)) return D{0};
+    if(value <= static_cast<S>(std::numeric_limits<D>::min())) return std::numeric_limits<D>::min();
+    if(value >= static_cast<S>(std::numeric_limits<D>::max())) return std::numeric_limits<D>::max();
+    return static_cast<D>(value);
+}
+
+template<typename D, typename S>
+typename std::enable_if<std::is_integral<D>::value && std::is_integral<S>::value && !std::is_same<S, bool>::value, D>::type npy_saturate_cast(S value) noexcept
+{
+    if(std::is_signed<S>::value && value < S{0})
+    {
+        if(!std::is_signed<D>::value) return D{0};
+        return static_cast<intmax_t>(value) < static_cast<intmax_t>(std::numeric_limits<D>::min()) ? std::numeric_limits<D>::min() : static_cast<D>(value);
+    }
+
+    return static_cast<uintmax_t>(value) > static_cast<uintmax_t>(std::numeric_limits<D>::max()) ? std::numeric_limits<D>::max() : static_cast<D>(value);
+}
+
+template<typename D, typename S>
+typename std::enable_if<std::is_floating_point<D>::value && std::is_integral<S>::value && !std::is_same<S, bool>::value, D>::type npy_saturate_cast(S value) noexcept
+{
+    return static_cast<D>(value);
+}
+
+template<typename D, typename S>
+typename std::enable_if<std::is_floating_point<D>::value && std::is_floating_point<S>::value, D>::type npy_saturate_cast(S value) noexcept
+{
+    // Only a narrowing conversion can overflow, infinities and NaN are preserved.
+    if(std::numeric_limits<S>::max() > std::numeric_limits<D>::max() && std::isfinite(value))
+    {
+        if(value > static_cast<S>(std::numeric_limits<D>::max())) return std::numeric_limits<D>::max();
+        if(value < static_cast<S>(std::numeric_limits<D>::lowest())) return std::numeric_limits<D>::lowest();
+    }
+
+    return static_cast<D>(value);
+}
+
+// Conversion of a single value, for every pair of supported types.
+
+template<typename D, typename S>
+typename std::enable_if<std::is_same<D, bool>::value, D>::type npy_convert_value(S value, bool saturate) noexcept
+{
+    return value != S{};
+}
+
+template<typename D, typename S>
+typename std::enable_if<!std::is_same<D, bool>::value && !npy_is_complex<D>::value && !npy_is_complex<S>::value, D>::type npy_convert_value(S value, bool saturate) noexcept
+{
+    return saturate ? npy_saturate_cast<D>(value) : static_cast<D>(value);
+}
+
+template<typename D, typename S>
+typename std::enable_if<npy_is_complex<D>::value && !npy_is_complex<S>::value, D>::type npy_convert_value(S value, bool saturate) noexcept
+{
+    return D{npy_convert_value<typename D::value_type>(value, saturate), typename D::value_type{0}};
+}
+
+template<typename D, typename S>
+typename std::enable_if<npy_is_complex<D>::value && npy_is_complex<S>::value, D>::type npy_convert_value(S value, bool saturate) noexcept
+{
+    return D{npy_convert_value<typename D::value_type>(value.real(), saturate), npy_convert_value<typename D::value_type>(value.imag(), saturate)};
+}
+
+template<typename D, typename S>
+typename std::enable_if<!std::is_same<D, bool>::value && !npy_is_complex<D>::value && npy_is_complex<S>::value, D>::type npy_convert_value(S value, bool saturate) noexcept
+{
+    // Discarding the imaginary part is refused by npy_convertible(), this overload only makes the dispatch compile.
+    return D{};
+}
+
+// Conversion of arrays, the loops are kept branch-free so that the compiler can vectorize them.
+
+template<typename S, typename D>
+void npy_convert_elements(const S* source, D* destination, size_t count, npy_cast cast) noexcept
+{
+    if(cast == npy_cast::cast_saturate)
+    {
+        for(size_t i = 0; i < count; i++) destination[i] = npy_convert_value<D>(source[i], true);
+    }
+    else
+    {
+        for(size_t i = 0; i < count; i++) destination[i] = npy_convert_value<D>(source[i], false);
+    }
+}
+
+template<typename S>
+void npy_convert_elements(const S* source, S* destination, size_t count, npy_cast cast) noexcept
+{
+    std::copy(source, source + count, destination);
+}
+
+inline void npy_convert_elements(const double* source, float* destination, size_t count, npy_cast cast) noexcept
+{
+    npy_double_to_float(source, destination, count, cast == npy_cast::cast_saturate);
+}
+
+template<typename T>
+bool npy_convertible(const npy_dtype& source_dtype) noexcept
+{
+    if(!npy_dtype::from_type<T>() || !source_dtype) return false;
+
+    if(source_dtype.kind() == npy_dtype_kind::complex && !npy_is_complex<T>::value && !std::is_same<T, bool>::value) return false;
+
+    if(source_dtype.with_byte_order(npy_endianness::native) == npy_dtype::float_16()) return true;
+
+    try
+    {
+        return npy_dtype_dispatch(source_dtype, [](auto* tag){return true;});
+    }
+    catch(const npy_array_exception& exception)
+    {
+        return false;
+    }
+}
+
+template<typename T>
+void npy_convert(const void* source, const npy_dtype& source_dtype, T* destination, size_t count, npy_cast cast)
+{
+    if(!npy_convertible<T>(source_dtype))
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+    }
+
+    if(source_dtype.with_byte_order(npy_endianness::native) == npy_dtype::float_16())
+    {
+        const uint16_t* half_source = static_cast<const uint16_t*>(source);
+
+        if(std::is_same<T, float>::value)
+        {
+            npy_half_to_float(half_source, reinterpret_cast<float*>(destination), count);
+            return;
+        }
+
+        // Widen to float a block at a time, the block stays in cache for the second conversion.
+        float block[half_block_size];
+
+        for(size_t offset = 0; offset < count; offset += half_block_size)
+        {
+            size_t block_count = std::min(half_block_size, count - offset);
+            npy_half_to_float(half_source + offset, block, block_count);
+            npy_convert_elements(static_cast<const float*>(block), destination + offset, block_count, cast);
+        }
+
+        return;
+    }
+
+    npy_dtype_dispatch(source_dtype, [&](auto* tag)
+    {
+        typedef std::remove_pointer_t<decltype(tag)> source_type;
+        npy_convert_elements(static_cast<const source_type*>(source), destination, count, cast);
+    });
+}
@@ -0,0 +1,549 @@
+#include "npy_array/npy_direct_io.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <climits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    // File descriptor closed when it goes out of scope.
+    class file_descriptor
+    {
+    public:
+        explicit file_descriptor(int descriptor) noexcept : _descriptor{descriptor} {}
+        file_descriptor(const file_descriptor& other) = delete;
+        file_descriptor& operator=(const file_descriptor& other) = delete;
+        ~file_descriptor() {if(_descriptor != -1) ::close(_descriptor);}
+
+        int get() const noexcept {return _descriptor;}
+
+    private:
+        int _descriptor;
+    };
+
+    struct free_deleter
+    {
+        void operator()(char* pointer) const noexcept {std::free(pointer);}
+    };
+
+    typedef std::unique_ptr<char, free_deleter> aligned_buffer;
+
+    size_t align_up(size_t value) noexcept
+    {
+        return (value + npy_direct_alignment - 1) / npy_direct_alignment * npy_direct_alignment;
+    }
+
+    // Whether the memory holding the byte at the given offset of a file is placed like the byte in the file, relative to the pages.
+    bool placed_like_file(const char* memory, uint64_t offset) noexcept
+    {
+        return (reinterpret_cast<uintptr_t>(memory) - offset) % npy_direct_alignment == 0;
+    }
+
+    aligned_buffer allocate_aligned(size_t size)
+    {
+        void* pointer = nullptr;
+
+        if(::posix_memalign(&pointer, npy_direct_alignment, size) != 0)
+        {
+            throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+        }
+
+        return aligned_buffer{static_cast<char*>(pointer)};
+    }
+
+    // Open with O_DIRECT, falling back to a buffered descriptor on the file systems that refuse it.
+    int open_direct(const std::string& path, int flags, bool& direct)
+    {
+        direct = true;
+        int descriptor = ::open(path.c_str(), flags | O_DIRECT | O_CLOEXEC, 0666);
+
+        if(descriptor == -1 && errno == EINVAL)
+        {
+            direct = false;
+            descriptor = ::open(path.c_str(), flags | O_CLOEXEC, 0666);
+        }
+
+        if(descriptor == -1)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        return descriptor;
+    }
+
+    // Read up to length bytes, retrying interrupted and short reads, return less than length only at the end of the file.
+    // If refused is not null, a read refused with EINVAL, like a direct read the device cannot serve in place, sets it instead of throwing.
+    size_t read_fully(int descriptor, char* buffer, size_t length, uint64_t offset, bool* refused = nullptr)
+    {
+        size_t done = 0;
+
+        while(done < length)
+        {
+            ssize_t result = ::pread(descriptor, buffer + done, length - done, static_cast<off_t>(offset + done));
+
+            if(result == -1 && errno == EINTR) continue;
+            if(result == -1 && errno == EINVAL && refused)
+            {
+                *refused = true;
+                return done;
+            }
+            if(result == -1) throw npy_array_exception{npy_array_exception_type::input_output_error};
+            if(result == 0) break;
+
+            done += static_cast<size_t>(result);
+        }
+
+        return done;
+    }
+
+    // Write length bytes, retrying interrupted and short writes, refused is set like read_fully() does.
+    void write_fully(int descriptor, const char* buffer, size_t length, uint64_t offset, bool* refused = nullptr)
+    {
+        size_t done = 0;
+
+        while(done < length)
+        {
+            ssize_t result = ::pwrite(descriptor, buffer + done, length - done, static_cast<off_t>(offset + done));
+
+            if(result == -1 && errno == EINTR) continue;
+            if(result == -1 && errno == EINVAL && refused)
+            {
+                *refused = true;
+                return;
+            }
+            if(result <= 0) throw npy_array_exception{npy_array_exception_type::input_output_error};
+
+            done += static_cast<size_t>(result);
+        }
+    }
+
+    // The size in bytes of the chunks in which a transformed payload is written, small enough to stay in cache.
+    const size_t transform_chunk_size = 1 << 20;
+
+    // Flush a file, or a directory, to the device.
+    void sync_path(const std::string& path, int flags)
+    {
+        file_descriptor descriptor{::open(path.c_str(), flags | O_CLOEXEC)};
+
+        if(descriptor.get() == -1 || ::fsync(descriptor.get()) == -1)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+    }
+
+    // The number of ranges of [offset, offset + length) split at the file offsets multiple of chunk_size.
+    size_t count_chunks(uint64_t offset, size_t length, size_t chunk_size) noexcept
+    {
+        return length == 0 ? 0 : static_cast<size_t>((offset + length - 1) / chunk_size - offset / chunk_size + 1);
+    }
+
+    // The range of the chunk-th chunk, relative to offset.
+    void chunk_range(uint64_t offset, size_t length, size_t chunk_size, size_t chunk, size_t& begin, size_t& end) noexcept
+    {
+        const uint64_t first = offset / chunk_size;
+        begin = chunk == 0 ? 0 : static_cast<size_t>((first + chunk) * chunk_size - offset);
+        end = static_cast<size_t>(std::min<uint64_t>((first + chunk + 1) * chunk_size - offset, length));
+    }
+}
+
+void npy_direct_read(const std::string& path, uint64_t offset, char* destination, size_t length, npy_thread_pool& pool, size_t chunk_size)
+{
+    bool direct;
+    file_descriptor descriptor{open_direct(path, O_RDONLY, direct)};
+
+    if(length == 0) return;
+
+    chunk_size = align_up(std::max(chunk_size, size_t(1)));
+
+    const uint64_t aligned_begin = offset / npy_direct_alignment * npy_direct_alignment;
+    const uint64_t aligned_end = align_up(offset + length);
+    const size_t chunks = (aligned_end - aligned_begin + chunk_size - 1) / chunk_size;
+    // Without O_DIRECT any range can be read in place.
+    const bool in_place = !direct || placed_like_file(destination, offset);
+
+    pool.parallel_for(0, chunks, [&](size_t begin, size_t end)
+    {
+        // One bounce buffer for every range of chunks, allocated only if a page cannot be read in place.
+        aligned_buffer buffer{};
+
+        // Read the pages [page_begin, page_end) into the bounce buffer, and copy their part inside the requested range.
+        auto read_bounced = [&](uint64_t page_begin, uint64_t page_end)
+        {
+            if(!buffer) buffer = allocate_aligned(chunk_size);
+
+            const uint64_t copy_begin = std::max<uint64_t>(page_begin, offset);
+            const uint64_t copy_end = std::min<uint64_t>(page_end, offset + length);
+
+            size_t read = read_fully(descriptor.get(), buffer.get(), static_cast<size_t>(page_end - page_begin), page_begin);
+
+            if(page_begin + read < copy_end)
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
+
+            std::memcpy(destination + (copy_begin - offset), buffer.get() + (copy_begin - page_begin), copy_end - copy_begin);
+        };
+
+        for(size_t chunk = begin; chunk < end; chunk++)
+        {
+            const uint64_t chunk_begin = aligned_begin + chunk * chunk_size;
+            const uint64_t chunk_end = std::min<uint64_t>(chunk_begin + chunk_size, aligned_end);
+
+            // The part of the chunk inside the requested range, and its whole pages which are read straight into destination.
+            const uint64_t copy_begin = std::max<uint64_t>(chunk_begin, offset);
+            const uint64_t copy_end = std::min<uint64_t>(chunk_end, offset + length);
+            const uint64_t inner_begin = direct ? align_up(copy_begin) : copy_begin;
+            const uint64_t inner_end = direct ? copy_end / npy_direct_alignment * npy_direct_alignment : copy_end;
+
+            if(!in_place || inner_begin >= inner_end)
+            {
+                read_bounced(chunk_begin, chunk_end);
+                continue;
+            }
+
+            // The partial pages at the ends of the range are shared with bytes outside of destination.
+            if(copy_begin < inner_begin) read_bounced(chunk_begin, inner_begin);
+
+            bool refused = false;
+            size_t read = read_fully(descriptor.get(), destination + (inner_begin - offset), static_cast<size_t>(inner_end - inner_begin), inner_begin, &refused);
+
+            if(refused)
+            {
+                read_bounced(inner_begin, inner_end);
+            }
+            else if(read != inner_end - inner_begin)
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
+
+            if(inner_end < copy_end) read_bounced(inner_end, chunk_end);
+        }
+    });
+
+    if(!direct)
+    {
+        ::posix_fadvise(descriptor.get(), static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+    }
+}
+
+void npy_direct_write(const std::string& path, uint64_t length, const std::function<void(uint64_t, char*, size_t)>& fill, npy_thread_pool& pool,
+                      size_t chunk_size, const char* source, uint64_t source_offset)
+{
+    bool direct;
+    file_descriptor descriptor{open_direct(path, O_WRONLY | O_CREAT | O_TRUNC, direct)};
+
+    chunk_size = align_up(std::max(chunk_size, size_t(1)));
+
+    const size_t chunks = (length + chunk_size - 1) / chunk_size;
+    const bool in_place = source && (!direct || placed_like_file(source, source_offset));
+
+    pool.parallel_for(0, chunks, [&](size_t begin, size_t end)
+    {
+        aligned_buffer buffer{};
+
+        // Fill the bounce buffer with the bytes [range_begin, range_end) and write them, padded to whole pages with O_DIRECT.
+        auto write_bounced = [&](uint64_t range_begin, uint64_t range_end)
+        {
+            if(!buffer) buffer = allocate_aligned(chunk_size);
+
+            const size_t range_length = static_cast<size_t>(range_end - range_begin);
+            const size_t padded_length = direct ? align_up(range_length) : range_length;
+
+            fill(range_begin, buffer.get(), range_length);
+            std::memset(buffer.get() + range_length, 0, padded_length - range_length);
+
+            write_fully(descriptor.get(), buffer.get(), padded_length, range_begin);
+        };
+
+        for(size_t chunk = begin; chunk < end; chunk++)
+        {
+            const uint64_t chunk_begin = chunk * chunk_size;
+            const uint64_t chunk_end = std::min<uint64_t>(chunk_begin + chunk_size, length);
+
+            // The whole pages of the chunk held by source are written straight from it.
+            const uint64_t covered_begin = std::max<uint64_t>(chunk_begin, source_offset);
+            const uint64_t inner_begin = direct ? align_up(covered_begin) : covered_begin;
+            const uint64_t inner_end = direct ? chunk_end / npy_direct_alignment * npy_direct_alignment : chunk_end;
+
+            if(!in_place || inner_begin >= inner_end)
+            {
+                write_bounced(chunk_begin, chunk_end);
+                continue;
+            }
+
+            if(chunk_begin < inner_begin) write_bounced(chunk_begin, inner_begin);
+
+            bool refused = false;
+            write_fully(descriptor.get(), source + (inner_begin - source_offset), static_cast<size_t>(inner_end - inner_begin), inner_begin, &refused);
+
+            if(refused) write_bounced(inner_begin, inner_end);
+
+            if(inner_end < chunk_end) write_bounced(inner_end, chunk_end);
+        }
+    });
+
+    // Remove the padding of the last chunk.
+    if(length % npy_direct_alignment != 0 && ::ftruncate(descriptor.get(), static_cast<off_t>(length)) == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    if(!direct)
+    {
+        // Dirty pages cannot be dropped, so they are written back first.
+        if(::fdatasync(descriptor.get()) == -1)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        ::posix_fadvise(descriptor.get(), 0, 0, POSIX_FADV_DONTNEED);
+    }
+}
+
+void npy_parallel_read(const std::string& path, uint64_t offset, char* destination, size_t length, npy_thread_pool& pool, size_t chunk_size,
+                       const std::function<void(char*, size_t)>& transform)
+{
+    file_descriptor descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+    if(descriptor.get() == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    chunk_size = align_up(std::max(chunk_size, size_t(1)));
+
+    pool.parallel_for(0, count_chunks(offset, length, chunk_size), [&](size_t first, size_t last)
+    {
+        for(size_t chunk = first; chunk < last; chunk++)
+        {
+            size_t begin, end;
+            chunk_range(offset, length, chunk_size, chunk, begin, end);
+
+            if(read_fully(descriptor.get(), destination + begin, end - begin, offset + begin) != end - begin)
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
+
+            if(transform)
+            {
+                transform(destination + begin, end - begin);
+            }
+        }
+    });
+}
+
+void npy_parallel_write(const std::string& path, const std::string& preamble, const char* payload, size_t length, npy_thread_pool& pool, size_t chunk_size,
+                        const std::function<void(char*, size_t)>& transform)
+{
+    file_descriptor descriptor{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)};
+
+    if(descriptor.get() == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    // Size the file up front, so that the writes of the ranges do not extend it concurrently.
+    if(::ftruncate(descriptor.get(), static_cast<off_t>(preamble.size() + length)) == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    write_fully(descriptor.get(), preamble.data(), preamble.size(), 0);
+
+    chunk_size = align_up(std::max(chunk_size, size_t(1)));
+
+    const uint64_t offset = preamble.size();
+
+    pool.parallel_for(0, count_chunks(offset, length, chunk_size), [&](size_t first, size_t last)
+    {
+        std::unique_ptr<char[]> buffer{};
+
+        if(transform)
+        {
+            try
+            {
+                buffer.reset(new char[std::min(chunk_size, length)]);
+            }
+            catch(const std::bad_alloc& bad_alloc_exception)
+            {
+                throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+            }
+        }
+
+        for(size_t chunk = first; chunk < last; chunk++)
+        {
+            size_t begin, end;
+            chunk_range(offset, length, chunk_size, chunk, begin, end);
+
+            const char* source = payload + begin;
+
+            if(transform)
+            {
+                std::memcpy(buffer.get(), source, end - begin);
+                transform(buffer.get(), end - begin);
+                source = buffer.get();
+            }
+
+            write_fully(descriptor.get(), source, end - begin, offset + begin);
+        }
+    });
+}
+
+void npy_gather_read(const std::string& path, const std::vector<npy_read_request>& requests, npy_thread_pool& pool)
+{
+    file_descriptor descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+    if(descriptor.get() == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    pool.parallel_for(0, requests.size(), [&](size_t first, size_t last)
+    {
+        for(size_t i = first; i < last; i++)
+        {
+            const npy_read_request& request = requests[i];
+
+            if(read_fully(descriptor.get(), request.destination, request.length, request.offset) != request.length)
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
+        }
+    });
+}
+
+void npy_write_file(const std::string& path, const char* preamble, size_t preamble_size, const char* payload, size_t length,
+                    const std::function<void(char*, size_t)>& transform)
+{
+    file_descriptor descriptor{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)};
+
+    if(descriptor.get() == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    if(transform)
+    {
+        write_fully(descriptor.get(), preamble, preamble_size, 0);
+
+        std::unique_ptr<char[]> buffer{new char[std::min(transform_chunk_size, length)]};
+
+        for(size_t offset = 0; offset < length; offset += transform_chunk_size)
+        {
+            const size_t count = std::min(transform_chunk_size, length - offset);
+            std::memcpy(buffer.get(), payload + offset, count);
+            transform(buffer.get(), count);
+            write_fully(descriptor.get(), buffer.get(), count, preamble_size + offset);
+        }
+
+        return;
+    }
+
+    iovec vectors[2] = {{const_cast<char*>(preamble), preamble_size}, {const_cast<char*>(payload), length}};
+    iovec* vector = vectors;
+    size_t remaining = preamble_size + length;
+
+    while(remaining > 0)
+    {
+        ssize_t result = ::writev(descriptor.get(), vector, static_cast<int>(vectors + 2 - vector));
+
+        if(result == -1 && errno == EINTR) continue;
+        if(result <= 0) throw npy_array_exception{npy_array_exception_type::input_output_error};
+
+        remaining -= static_cast<size_t>(result);
+
+        // Skip what has been written, a short write resumes in the middle of a vector.
+        size_t written = static_cast<size_t>(result);
+
+        while(remaining > 0 && written >= vector->iov_len)
+        {
+            written -= vector->iov_len;
+            vector++;
+        }
+
+        if(remaining > 0)
+        {
+            vector->iov_base = static_cast<char*>(vector->iov_base) + written;
+            vector->iov_len -= written;
+        }
+    }
+}
+
+std::string npy_commit_path(const std::string& path)
+{
+    struct stat link_status;
+
+    // A new file is created at the path.
+    if(::lstat(path.c_str(), &link_status) == -1)
+    {
+        return path;
+    }
+
+    if(S_ISREG(link_status.st_mode))
+    {
+        return path;
+    }
+
+    if(!S_ISLNK(link_status.st_mode))
+    {
+        return std::string{};
+    }
+
+    // Rename over the target of the links, so that the links keep pointing to the new file.
+    char resolved[PATH_MAX];
+    struct stat target_status;
+
+    if(::realpath(path.c_str(), resolved) == nullptr || ::stat(resolved, &target_status) == -1 || !S_ISREG(target_status.st_mode))
+    {
+        return std::string{};
+    }
+
+    return std::string{resolved};
+}
+
+std::string npy_temporary_path(const std::string& path)
+{
+    static std::atomic<uint64_t> counter{0};
+
+    return path + ".tmp" + std::to_string(::getpid()) + "." + std::to_string(counter++);
+}
+
+void npy_commit_file(const std::string& temporary_path, const std::string& path, bool sync)
+{
+    if(sync)
+    {
+        sync_path(temporary_path, O_RDONLY);
+    }
+
+    if(temporary_path == path) return;
+
+    // The new file keeps the permissions of the one it replaces.
+    struct stat status;
+
+    if(::stat(path.c_str(), &status) == 0 && ::chmod(temporary_path.c_str(), status.st_mode & 07777) == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    if(::rename(temporary_path.c_str(), path.c_str()) == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    if(sync)
+    {
+        // The new name is durable once the directory is.
+        const size_t separator = path.find_last_of('/');
+        sync_path(separator == std::string::npos ? "." : separator == 0 ? "/" : path.substr(0, separator), O_RDONLY | O_DIRECTORY);
+    }
+}
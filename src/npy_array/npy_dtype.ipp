@@ -0,0 +1,169 @@
+#include "npy_array/npy_dtype.h"
+
+// Initialize the null dtype with unknown kind, item size 0, and endianess not applicable.
+constexpr npy_dtype::npy_dtype() noexcept 
+    : _kind{npy_dtype_kind::unkwown}, _item_size{0}, _byte_order{npy_endianness::not_applicable} {}
+
+// Initialize the attributes with the ones provided by the user.
+// No checks are performed for the given input parameters.
+constexpr npy_dtype::npy_dtype(npy_dtype_kind kind, size_t item_size, npy_endianness byte_order) noexcept
+    : _kind{kind}, _item_size{item_size}, _byte_order{byte_order} {}
+
+// Move constructor, copy the attributes from the other dtype and then make the other identical to the null dtype.
+constexpr npy_dtype::npy_dtype(npy_dtype&& other) noexcept
+    : _kind{other._kind}, _item_size{other._item_size}, _byte_order{other._byte_order}
+{
+    if(this != &other)
+    {
+        // Make the other equals to null dtype.
+        other._kind = npy_dtype_kind::unkwown;
+        other._item_size = 0;
+        other._byte_order = npy_endianness::not_applicable;
+    }
+}
+
+// Move assignment.
+constexpr npy_dtype& npy_dtype::operator=(npy_dtype&& other) noexcept
+{
+    if(this != &other)
+    {
+        // Move the attributes from the other dtype.
+        _kind = other._kind;
+        _item_size = other._item_size;
+        _byte_order = other._byte_order;
+
+        // Make the other equals to null dtype.
+        other._kind = npy_dtype_kind::unkwown;
+        other._item_size = 0;
+        other._byte_order = npy_endianness::not_applicable;
+    }
+
+    return *this;
+}
+
+// Only the null dtype has the unknown kind.
+constexpr npy_dtype::operator bool() const noexcept {return _kind != npy_dtype_kind::unkwown;}
+
+constexpr bool npy_dtype::operator==(const npy_dtype& other) const noexcept
+{
+    return _kind == other._kind && _item_size == other._item_size && _byte_order == other._byte_order;
+}
+
+constexpr bool npy_dtype::operator!=(const npy_dtype& other) const noexcept
+{
+    return !(*this == other);
+}
+
+constexpr npy_dtype_kind npy_dtype::kind() const noexcept {return _kind;} // Return the private npy_dtype_kind.
+constexpr size_t npy_dtype::item_size() const noexcept {return _item_size;} // Return the private item size.
+constexpr npy_endianness npy_dtype::byte_order() const noexcept {return _byte_order;} // Return the private npy_endianess.
+
+constexpr npy_dtype_string npy_dtype::descr() const noexcept
+{
+    // Push in order the byte order (endianess), the kind, and the item size, which has at most two digits.
+    npy_dtype_string dtype_string{};
+    dtype_string.characters[dtype_string.length++] = static_cast<char>(_byte_order);
+    dtype_string.characters[dtype_string.length++] = static_cast<char>(_kind);
+    if(_item_size >= 10) dtype_string.characters[dtype_string.length++] = static_cast<char>('0' + _item_size / 10 % 10);
+    dtype_string.characters[dtype_string.length++] = static_cast<char>('0' + _item_size % 10);
+    return dtype_string;
+}
+
+constexpr npy_dtype npy_dtype::with_byte_order(npy_endianness byte_order) const noexcept
+{
+    // Single byte dtypes and the null dtype have no byte order.
+    if(_byte_order == npy_endianness::not_applicable) return *this;
+
+    if(byte_order == npy_endianness::native) byte_order = get_endianess();
+
+    return npy_dtype{_kind, _item_size, byte_order};
+}
+
+constexpr npy_dtype npy_dtype::from_string(const char* dtype_string, size_t length) noexcept
+{
+    // The one byte types have no byte order and an explicit item size, so they are compared literally.
+    if(length == 3 && dtype_string[0] == '|' && dtype_string[2] == '1')
+    {
+        switch(dtype_string[1])
+        {
+        case 'b': return npy_dtype::bool_8();
+        case 'i': return npy_dtype::int_8();
+        case 'u': return npy_dtype::uint_8();
+        default: return npy_dtype::null();
+        }
+    }
+
+    size_t position = 0;
+    npy_endianness byte_order = get_endianess(); // By default use native endianess.
+
+    // The byte order is optional, the native one is resolved to the machine endianess.
+    if(position < length && (dtype_string[position] == '<' || dtype_string[position] == '>'))
+    {
+        byte_order = static_cast<npy_endianness>(dtype_string[position++]);
+    }
+    else if(position < length && dtype_string[position] == '=')
+    {
+        position++;
+    }
+
+    // The kind is mandatory, the one byte kind is accepted only by the literal comparison above.
+    if(position == length) return npy_dtype::null();
+
+    const char kind_character = dtype_string[position++];
+
+    if(kind_character != 'i' && kind_character != 'u' && kind_character != 'f' && kind_character != 'c') return npy_dtype::null();
+
+    const npy_dtype_kind kind = static_cast<npy_dtype_kind>(kind_character);
+
+    // The item size is optional, by default it is 8 bytes for integer, either signed or unsigned, and floating points, and 16 bytes for the complex type.
+    size_t item_size = kind == npy_dtype_kind::complex ? 16 : 8;
+
+    if(position < length)
+    {
+        // At most two digits, without leading zeros.
+        if(length - position > 2 || dtype_string[position] == '0') return npy_dtype::null();
+
+        item_size = 0;
+
+        for(; position < length; position++)
+        {
+            if(dtype_string[position] < '0' || dtype_string[position] > '9') return npy_dtype::null();
+            item_size = item_size * 10 + static_cast<size_t>(dtype_string[position] - '0');
+        }
+
+        // Only the implemented item sizes of each kind are allowed.
+        switch(kind)
+        {
+        case npy_dtype_kind::integer:
+        case npy_dtype_kind::not_signed:
+            if(item_size != 2 && item_size != 4 && item_size != 8) return npy_dtype::null();
+            break;
+        case npy_dtype_kind::floating_point:
+            if(item_size != 2 && item_size != 4 && item_size != 8 && item_size != 16) return npy_dtype::null();
+            break;
+        default:
+            if(item_size != 8 && item_size != 16 && item_size != 32) return npy_dtype::null();
+            break;
+        }
+    }
+
+    return npy_dtype{kind, item_size, byte_order};
+}
+
+constexpr npy_dtype npy_dtype::bool_8() noexcept {return npy_dtype{npy_dtype_kind::boolean, sizeof(bool), npy_endianness::not_applicable};}
+constexpr npy_dtype npy_dtype::int_8() noexcept {return npy_dtype{npy_dtype_kind::integer, sizeof(int8_t),npy_endianness::not_applicable};}
+constexpr npy_dtype npy_dtype::int_16() noexcept {return npy_dtype{npy_dtype_kind::integer, sizeof(int16_t)};}
+constexpr npy_dtype npy_dtype::int_32() noexcept {return npy_dtype{npy_dtype_kind::integer, sizeof(int32_t)};}
+constexpr npy_dtype npy_dtype::int_64() noexcept {return npy_dtype{npy_dtype_kind::integer, sizeof(int64_t)};}
+constexpr npy_dtype npy_dtype::uint_8() noexcept {return npy_dtype{npy_dtype_kind::not_signed, sizeof(uint8_t), npy_endianness::not_applicable};}
+constexpr npy_dtype npy_dtype::uint_16() noexcept {return npy_dtype{npy_dtype_kind::not_signed, sizeof(uint16_t)};}
+constexpr npy_dtype npy_dtype::uint_32() noexcept {return npy_dtype{npy_dtype_kind::not_signed, sizeof(uint32_t)};}
+constexpr npy_dtype npy_dtype::uint_64() noexcept {return npy_dtype{npy_dtype_kind::not_signed, sizeof(uint64_t)};}
+constexpr npy_dtype npy_dtype::float_16() noexcept {return npy_dtype{npy_dtype_kind::floating_point, 2};}
+constexpr npy_dtype npy_dtype::float_32() noexcept {return npy_dtype{npy_dtype_kind::floating_point, sizeof(float)};}
+constexpr npy_dtype npy_dtype::float_64() noexcept {return npy_dtype{npy_dtype_kind::floating_point, sizeof(double)};}
+constexpr npy_dtype npy_dtype::float_128() noexcept {return npy_dtype{npy_dtype_kind::floating_point, sizeof(long double)};}
+constexpr npy_dtype npy_dtype::complex_64() noexcept {return npy_dtype{npy_dtype_kind::complex, sizeof(std::complex<float>)};}
+constexpr npy_dtype npy_dtype::complex_128() noexcept {return npy_dtype{npy_dtype_kind::complex, sizeof(std::complex<double>)};}
+constexpr npy_dtype npy_dtype::complex_256() noexcept {return npy_dtype{npy_dtype_kind::complex, sizeof(std::complex<long double>)};}
+constexpr npy_dtype npy_dtype::null() noexcept {return npy_dtype{};}
@@ -21,6 +21,10 @@ const char* npy_array_exception::what()
             return "The dtype required is not supported.";
         case npy_array_exception_type::unmatched_shape_data:
             return "The sizes of shape and data are mismatched.";
+        case npy_array_exception_type::unsupported_layout:
+            return "The memory layout of the array is not supported by this operation.";
+        case npy_array_exception_type::invalid_archive:
+            return "The archive is corrupted or uses an unsupported ZIP feature.";
         case npy_array_exception_type::generic:
             return "There has been an error.";
         }
@@ -0,0 +1,639 @@
+#include "npy_array/npy_header.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <endian.h>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    // The size of the magic string plus the two version bytes.
+    const size_t magic_version_size = 8;
+    // The header dictionaries up to this length are read in a buffer on the stack.
+    const size_t stack_dictionary_size = 1024;
+    // The number of bytes read at once by probe(), enough for the preamble of almost every file.
+    const size_t probe_read_size = 512;
+    // The shapes up to this number of dimensions are parsed on the stack, NumPy itself allows at most 64 dimensions.
+    const size_t stack_dimensions = 64;
+
+    [[noreturn]] void throw_ill_formed_header()
+    {
+        throw npy_array_exception{npy_array_exception_type::ill_formed_header};
+    }
+
+    // Whether the number of bytes of a payload of the given shape, and thus its number of elements, fit in a size_t.
+    bool fits_in_size(const std::vector<size_t>& shape, size_t item_size) noexcept
+    {
+        if(std::find(shape.cbegin(), shape.cend(), size_t(0)) != shape.cend()) return true;
+
+        size_t byte_size = std::max(item_size, size_t(1));
+
+        for(size_t dimension : shape)
+        {
+            if(byte_size > std::numeric_limits<size_t>::max() / dimension) return false;
+            byte_size *= dimension;
+        }
+
+        return true;
+    }
+
+    // Cursor over the characters of a header dictionary, the Python literals are recognized in place.
+    // Every syntax error throws ill_formed_header.
+    class dictionary_cursor
+    {
+    public:
+        dictionary_cursor(const char* begin, const char* end) noexcept : _position{begin}, _end{end} {}
+
+        bool at_end() noexcept
+        {
+            skip_whitespace();
+            return _position == _end;
+        }
+
+        // Consume the given character if it is the next one, whitespace excluded.
+        bool accept(char character) noexcept
+        {
+            skip_whitespace();
+
+            if(_position != _end && *_position == character)
+            {
+                _position++;
+                return true;
+            }
+
+            return false;
+        }
+
+        void expect(char character)
+        {
+            if(!accept(character)) throw_ill_formed_header();
+        }
+
+        // A string quoted with single or double quotes, without escape sequences.
+        void string_literal(const char*& begin, size_t& length)
+        {
+            skip_whitespace();
+
+            if(_position == _end || (*_position != '\'' && *_position != '"')) throw_ill_formed_header();
+
+            const char quote = *_position++;
+            begin = _position;
+
+            while(_position != _end && *_position != quote)
+            {
+                if(*_position == '\\' || *_position == '\n') throw_ill_formed_header();
+                _position++;
+            }
+
+            if(_position == _end) throw_ill_formed_header();
+
+            length = static_cast<size_t>(_position - begin);
+            _position++;
+        }
+
+        bool boolean_literal()
+        {
+            skip_whitespace();
+
+            if(keyword("True")) return true;
+            if(keyword("False")) return false;
+
+            throw_ill_formed_header();
+        }
+
+        // A non negative decimal integer, without leading zeros and with an optional Python 2 'L' suffix.
+        size_t integer_literal()
+        {
+            skip_whitespace();
+
+            if(_position == _end || !is_digit(*_position)) throw_ill_formed_header();
+            if(*_position == '0' && _position + 1 != _end && is_digit(_position[1])) throw_ill_formed_header();
+
+            size_t value = 0;
+
+            for(; _position != _end && is_digit(*_position); _position++)
+            {
+                const size_t digit = static_cast<size_t>(*_position - '0');
+
+                if(value > (std::numeric_limits<size_t>::max() - digit) / 10) throw_ill_formed_header();
+
+                value = value * 10 + digit;
+            }
+
+            if(_position != _end && (*_position == 'L' || *_position == 'l')) _position++;
+
+            return value;
+        }
+
+    private:
+        static bool is_digit(char character) noexcept {return character >= '0' && character <= '9';}
+
+        void skip_whitespace() noexcept
+        {
+            while(_position != _end && (*_position == ' ' || *_position == '\t' || *_position == '\n' || *_position == '\r')) _position++;
+        }
+
+        // Consume the given word if it is not the prefix of a longer identifier.
+        bool keyword(const char* word) noexcept
+        {
+            const size_t length = std::strlen(word);
+
+            if(static_cast<size_t>(_end - _position) < length || std::memcmp(_position, word, length) != 0) return false;
+
+            const char* next = _position + length;
+
+            if(next != _end && (std::isalnum(static_cast<unsigned char>(*next)) || *next == '_')) return false;
+
+            _position = next;
+            return true;
+        }
+
+        const char* _position;
+        const char* _end;
+    };
+
+    bool equals(const char* characters, size_t length, const char* literal) noexcept
+    {
+        return std::strlen(literal) == length && std::memcmp(characters, literal, length) == 0;
+    }
+
+    // Compute the version and the header length of a preamble containing a dictionary of the given length.
+    // The smallest version that fits is used: 1.0 has a 2 bytes header length, 2.0 a 4 bytes one.
+    // The dictionaries written are pure ASCII, so 3.0, whose header is read as UTF-8, is never needed.
+    void preamble_layout(size_t dictionary_length, size_t minimum_size, uint8_t& major_version, size_t& header_length)
+    {
+        for(size_t length_size : {size_t(2), size_t(4)})
+        {
+            // The dictionary is followed by a '\n' and the whole preamble is padded to a multiple of 64.
+            size_t preamble_size = std::max(magic_version_size + length_size + dictionary_length + 1, minimum_size);
+            preamble_size = (preamble_size + 63) / 64 * 64;
+
+            header_length = preamble_size - magic_version_size - length_size;
+
+            if(length_size == 2 && header_length <= std::numeric_limits<uint16_t>::max())
+            {
+                major_version = 0x1;
+                return;
+            }
+        }
+
+        major_version = 0x2;
+    }
+
+    // Append characters to a buffer as long as they fit in it, counting them all.
+    class dictionary_writer
+    {
+    public:
+        dictionary_writer(char* buffer, size_t capacity) noexcept : _buffer{buffer}, _capacity{capacity}, _length{0} {}
+
+        void append(const char* characters, size_t length) noexcept
+        {
+            if(_length + length <= _capacity)
+            {
+                std::memcpy(_buffer + _length, characters, length);
+            }
+
+            _length += length;
+        }
+
+        void append(const char* literal) noexcept {this->append(literal, std::strlen(literal));}
+
+        void append(size_t value) noexcept
+        {
+            char digits[std::numeric_limits<size_t>::digits10 + 1];
+            char* first = digits + sizeof(digits);
+
+            do
+            {
+                *--first = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            while(value != 0);
+
+            this->append(first, digits + sizeof(digits) - first);
+        }
+
+        size_t length() const noexcept {return _length;}
+
+    private:
+        char* _buffer;
+        size_t _capacity;
+        size_t _length;
+    };
+}
+
+npy_header::npy_header() noexcept
+    : _dtype{}, _fortran_order{false}, _shape{}, _major_version{0x1}, _header_length{0} {}
+
+npy_header::npy_header(const npy_dtype& dtype, bool fortran_order, const std::vector<size_type>& shape)
+    : _dtype{dtype}, _fortran_order{fortran_order}, _shape{shape}, _major_version{0x1}, _header_length{0}
+{
+    preamble_layout(this->format_dictionary(nullptr, 0), 0, _major_version, _header_length);
+}
+
+npy_header npy_header::read(std::istream& array_stream)
+{
+    npy_header header{};
+
+    try
+    {
+        std::string magic_string(6, '\0');
+        array_stream.read(&magic_string[0], magic_string.size());
+
+        if(!array_stream)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        if(magic_string != "\x93NUMPY")
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_magic_string};
+        }
+
+        uint8_t minor_version;
+
+        array_stream.read(reinterpret_cast<char*>(&header._major_version), 1);
+        array_stream.read(reinterpret_cast<char*>(&minor_version), 1);
+
+        if(!array_stream)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        // Version 1.0 has a 2 bytes header length, version 2.0 and 3.0 have a 4 bytes one.
+        // Version 3.0 only differs from 2.0 because the header is encoded in UTF-8 instead of latin-1.
+        if(header._major_version < 0x1 || header._major_version > 0x3)
+        {
+            throw npy_array_exception{npy_array_exception_type::unsupported_version};
+        }
+
+        if(header._major_version == 0x1)
+        {
+            uint16_t header_length;
+            array_stream.read(reinterpret_cast<char*>(&header_length), 2);
+            header._header_length = le16toh(header_length);
+        }
+        else
+        {
+            uint32_t header_length;
+            array_stream.read(reinterpret_cast<char*>(&header_length), 4);
+            header._header_length = le32toh(header_length);
+        }
+
+        if(!array_stream)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        // Do not trust the header length before knowing that the stream is actually that long.
+        std::streampos header_start = array_stream.tellg();
+        array_stream.seekg(0, std::ios_base::end);
+        std::streamoff remaining_length = array_stream.tellg() - header_start;
+        array_stream.seekg(header_start);
+
+        if(!array_stream || static_cast<std::streamoff>(header._header_length) > remaining_length)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        // The header of almost every file fits on the stack, only the longer ones are read in memory allocated on purpose.
+        char stack_dictionary[stack_dictionary_size];
+        std::string heap_dictionary{};
+        char* header_dictionary = stack_dictionary;
+
+        if(header._header_length > stack_dictionary_size)
+        {
+            heap_dictionary.resize(header._header_length);
+            header_dictionary = &heap_dictionary[0];
+        }
+
+        array_stream.read(header_dictionary, header._header_length);
+
+        if(!array_stream)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        header.parse(header_dictionary, header._header_length);
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    return header;
+}
+
+npy_header npy_header::probe(const std::string& array_path)
+{
+    int descriptor = ::open(array_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if(descriptor == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    // Read up to length bytes at offset, retrying interrupted and short reads, return less than length only at the end of the file.
+    auto read_at = [descriptor](char* buffer, size_t length, off_t offset)
+    {
+        size_t done = 0;
+
+        while(done < length)
+        {
+            ssize_t result = ::pread(descriptor, buffer + done, length - done, offset + static_cast<off_t>(done));
+
+            if(result == -1 && errno == EINTR) continue;
+            if(result <= 0) break;
+
+            done += static_cast<size_t>(result);
+        }
+
+        return done;
+    };
+
+    npy_header header{};
+
+    try
+    {
+        char preamble[probe_read_size];
+        const size_t preamble_length = read_at(preamble, sizeof(preamble), 0);
+
+        if(preamble_length < magic_version_size + 2)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        if(std::memcmp(preamble, "\x93NUMPY", 6) != 0)
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_magic_string};
+        }
+
+        header._major_version = static_cast<uint8_t>(preamble[6]);
+
+        if(header._major_version < 0x1 || header._major_version > 0x3)
+        {
+            throw npy_array_exception{npy_array_exception_type::unsupported_version};
+        }
+
+        size_t length_size = 2;
+
+        if(header._major_version == 0x1)
+        {
+            uint16_t header_length;
+            std::memcpy(&header_length, preamble + magic_version_size, sizeof(uint16_t));
+            header._header_length = le16toh(header_length);
+        }
+        else
+        {
+            length_size = 4;
+
+            if(preamble_length < magic_version_size + length_size)
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
+
+            uint32_t header_length;
+            std::memcpy(&header_length, preamble + magic_version_size, sizeof(uint32_t));
+            header._header_length = le32toh(header_length);
+        }
+
+        const size_t dictionary_offset = magic_version_size + length_size;
+
+        if(dictionary_offset + header._header_length <= preamble_length)
+        {
+            header.parse(preamble + dictionary_offset, header._header_length);
+        }
+        else
+        {
+            // Only the longer headers need a second read, do not trust their length before knowing that the file is that long.
+            struct stat file_status;
+
+            if(::fstat(descriptor, &file_status) == -1 || static_cast<uint64_t>(file_status.st_size) < dictionary_offset + header._header_length)
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
+
+            std::string dictionary(header._header_length, '\0');
+
+            if(read_at(&dictionary[0], dictionary.size(), static_cast<off_t>(dictionary_offset)) != dictionary.size())
+            {
+                throw npy_array_exception{npy_array_exception_type::input_output_error};
+            }
+
+            header.parse(dictionary.data(), dictionary.size());
+        }
+    }
+    catch(...)
+    {
+        ::close(descriptor);
+        throw;
+    }
+
+    ::close(descriptor);
+
+    return header;
+}
+
+npy_header npy_header::from_dictionary(const char* dictionary, size_type length)
+{
+    npy_header header{};
+    header._header_length = length;
+    header.parse(dictionary, length);
+    return header;
+}
+
+void npy_header::parse(const char* dictionary, size_type length)
+{
+    dictionary_cursor cursor{dictionary, dictionary + length};
+
+    bool descr_found = false;
+    bool fortran_order_found = false;
+    bool shape_found = false;
+
+    // The shape is parsed on the stack and copied once into the member, unless it has an unusual number of dimensions.
+    size_type shape[stack_dimensions];
+    size_type dimensions = 0;
+
+    cursor.expect('{');
+
+    while(!cursor.accept('}'))
+    {
+        const char* key;
+        size_t key_length;
+
+        cursor.string_literal(key, key_length);
+        cursor.expect(':');
+
+        // Each key is allowed once, in any order.
+        if(!descr_found && equals(key, key_length, "descr"))
+        {
+            const char* descr;
+            size_t descr_length;
+
+            cursor.string_literal(descr, descr_length);
+            _dtype = npy_dtype::from_string(descr, descr_length);
+
+            if(!_dtype) throw_ill_formed_header();
+
+            descr_found = true;
+        }
+        else if(!fortran_order_found && equals(key, key_length, "fortran_order"))
+        {
+            _fortran_order = cursor.boolean_literal();
+            fortran_order_found = true;
+        }
+        else if(!shape_found && equals(key, key_length, "shape"))
+        {
+            bool trailing_comma = false;
+
+            cursor.expect('(');
+
+            while(!cursor.accept(')'))
+            {
+                // A zero dimension, like the one of np.zeros((0, 3)), makes the payload empty.
+                const size_type dimension = cursor.integer_literal();
+
+                if(dimensions < stack_dimensions)
+                {
+                    shape[dimensions] = dimension;
+                }
+                else
+                {
+                    if(dimensions == stack_dimensions) _shape.assign(shape, shape + stack_dimensions);
+                    _shape.push_back(dimension);
+                }
+
+                dimensions++;
+                trailing_comma = cursor.accept(',');
+
+                if(!trailing_comma)
+                {
+                    cursor.expect(')');
+                    break;
+                }
+            }
+
+            // Without the trailing comma, "(5)" is an integer in Python and not a 1-tuple.
+            if(dimensions == 1 && !trailing_comma) throw_ill_formed_header();
+
+            shape_found = true;
+        }
+        else
+        {
+            throw_ill_formed_header();
+        }
+
+        // The entries are separated by commas, and the last one can be followed by a comma too.
+        if(!cursor.accept(','))
+        {
+            cursor.expect('}');
+            break;
+        }
+    }
+
+    // Only the padding can follow the dictionary.
+    if(!cursor.at_end()) throw_ill_formed_header();
+
+    if(!descr_found || !fortran_order_found || !shape_found)
+    {
+        throw_ill_formed_header();
+    }
+
+    if(dimensions <= stack_dimensions) _shape.assign(shape, shape + dimensions);
+
+    // A crafted shape would otherwise wrap size() and byte_size(), which bound the reads and the allocations.
+    if(!fits_in_size(_shape, _dtype.item_size())) throw_ill_formed_header();
+}
+
+size_t npy_header::format_dictionary(char* buffer, size_type capacity) const noexcept
+{
+    dictionary_writer writer{buffer, capacity};
+    const npy_dtype_string descr = _dtype.descr();
+
+    writer.append("{'descr': '");
+    writer.append(descr.c_str(), descr.size());
+    writer.append("', 'fortran_order': ");
+    writer.append(_fortran_order ? "True" : "False");
+    writer.append(", 'shape': (");
+
+    for(size_type i = 0; i < _shape.size(); i++)
+    {
+        if(i > 0) writer.append(", ");
+        writer.append(_shape[i]);
+    }
+
+    // A 1-d shape must be written as a 1-tuple, "(10,)", like Python does.
+    writer.append(_shape.size() == 1 ? ",), }" : "), }");
+
+    return writer.length();
+}
+
+size_t npy_header::write_preamble(char* buffer, size_type capacity, size_type minimum_size) const noexcept
+{
+    const size_type dictionary_length = this->format_dictionary(nullptr, 0);
+
+    uint8_t major_version;
+    size_type header_length;
+    preamble_layout(dictionary_length, minimum_size, major_version, header_length);
+
+    const size_type length_size = major_version == 0x1 ? sizeof(uint16_t) : sizeof(uint32_t);
+    const size_type preamble_size = magic_version_size + length_size + header_length;
+
+    if(preamble_size > capacity)
+    {
+        return preamble_size;
+    }
+
+    std::memcpy(buffer, "\x93NUMPY", 6);
+    buffer[6] = static_cast<char>(major_version);
+    buffer[7] = '\x00';
+
+    if(major_version == 0x1)
+    {
+        uint16_t length = htole16(static_cast<uint16_t>(header_length));
+        std::memcpy(buffer + magic_version_size, &length, sizeof(uint16_t));
+    }
+    else
+    {
+        uint32_t length = htole32(static_cast<uint32_t>(header_length));
+        std::memcpy(buffer + magic_version_size, &length, sizeof(uint32_t));
+    }
+
+    // Pad the dictionary with spaces and terminate it with a '\n'.
+    char* dictionary = buffer + magic_version_size + length_size;
+    this->format_dictionary(dictionary, dictionary_length);
+    std::memset(dictionary + dictionary_length, '\x20', header_length - dictionary_length - 1);
+    dictionary[header_length - 1] = '\n';
+
+    return preamble_size;
+}
+
+std::string npy_header::str(size_type minimum_size) const
+{
+    std::string preamble(this->write_preamble(nullptr, 0, minimum_size), '\0');
+    this->write_preamble(&preamble[0], preamble.size(), minimum_size);
+
+    return preamble;
+}
+
+const npy_dtype& npy_header::dtype() const noexcept {return _dtype;}
+bool npy_header::fortran_order() const noexcept {return _fortran_order;}
+const std::vector<size_t>& npy_header::shape() const noexcept {return _shape;}
+uint8_t npy_header::major_version() const noexcept {return _major_version;}
+size_t npy_header::header_length() const noexcept {return _header_length;}
+size_t npy_header::payload_offset() const noexcept {return magic_version_size + (_major_version == 0x1 ? 2 : 4) + _header_length;}
+
+size_t npy_header::size() const noexcept
+{
+    return std::accumulate(_shape.cbegin(), _shape.cend(), size_t(1), std::multiplies<size_t>());
+}
+
+size_t npy_header::byte_size() const noexcept {return this->size() * _dtype.item_size();}
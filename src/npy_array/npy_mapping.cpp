@@ -0,0 +1,101 @@
+#include "npy_array/npy_mapping.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+npy_mapping::npy_mapping() noexcept
+    : _data{nullptr}, _size{0}, _writable{false} {}
+
+npy_mapping::npy_mapping(const std::string& path, bool writable)
+    : npy_mapping{}
+{
+    int file_descriptor = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+
+    if(file_descriptor == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    struct stat file_status;
+
+    if(::fstat(file_descriptor, &file_status) == -1)
+    {
+        ::close(file_descriptor);
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    _size = static_cast<size_t>(file_status.st_size);
+
+    this->map(file_descriptor, writable);
+}
+
+std::shared_ptr<npy_mapping> npy_mapping::create(const std::string& path, size_t size)
+{
+    int file_descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+
+    if(file_descriptor == -1)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    // Extend the file to its final size, the new bytes read as zeros and are allocated lazily by the file system.
+    if(::ftruncate(file_descriptor, static_cast<off_t>(size)) == -1)
+    {
+        ::close(file_descriptor);
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    std::shared_ptr<npy_mapping> mapping{new npy_mapping{}};
+    mapping->_size = size;
+    mapping->map(file_descriptor, true);
+
+    return mapping;
+}
+
+void npy_mapping::map(int file_descriptor, bool writable)
+{
+    _writable = writable;
+
+    // An empty file cannot be mapped, the mapping is simply left empty.
+    if(_size > 0)
+    {
+        int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* address = ::mmap(nullptr, _size, protection, MAP_SHARED, file_descriptor, 0);
+
+        if(address == MAP_FAILED)
+        {
+            ::close(file_descriptor);
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+
+        _data = static_cast<char*>(address);
+    }
+
+    // The mapping keeps its own reference to the file, the descriptor is no longer needed.
+    ::close(file_descriptor);
+}
+
+npy_mapping::~npy_mapping()
+{
+    if(_data != nullptr)
+    {
+        ::munmap(_data, _size);
+    }
+}
+
+char* npy_mapping::data() const noexcept {return _data;}
+size_t npy_mapping::size() const noexcept {return _size;}
+bool npy_mapping::writable() const noexcept {return _writable;}
+
+void npy_mapping::sync(bool asynchronous)
+{
+    if(_writable && _data != nullptr)
+    {
+        if(::msync(_data, _size, asynchronous ? MS_ASYNC : MS_SYNC) == -1)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+    }
+}
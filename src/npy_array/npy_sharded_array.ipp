@@ -0,0 +1,317 @@
+#include "npy_array/npy_sharded_array.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+template<typename T>
+npy_sharded_array<T>::npy_sharded_array(const std::vector<std::string>& paths, size_type max_open_shards, npy_thread_pool& pool)
+    : _paths{paths}, _headers{}, _first_rows{}, _shape{}, _row_shape{}, _row_size{0}, _max_open_shards{max_open_shards}, _cache{new shard_cache{}}
+{
+    if(paths.empty())
+    {
+        throw std::invalid_argument{"npy_sharded_array requires at least one path"};
+    }
+
+    if(max_open_shards == 0)
+    {
+        throw std::invalid_argument{"npy_sharded_array requires at least one open shard"};
+    }
+
+    std::vector<npy_probe_item> items = npy_probe_batch(paths, pool);
+
+    _headers.reserve(items.size());
+    _first_rows.reserve(items.size() + 1);
+    _first_rows.push_back(0);
+
+    for(const npy_probe_item& item : items)
+    {
+        if(!item.probed)
+        {
+            throw npy_array_exception{item.error};
+        }
+
+        const npy_header& header = item.header;
+
+        if(header.dtype().with_byte_order(npy_endianness::native) != npy_dtype::from_type<T>())
+        {
+            throw npy_array_exception{npy_array_exception_type::ill_formed_header};
+        }
+
+        // The rows of a Fortran-ordered payload are scattered, a 0-d array has none.
+        if(header.fortran_order() || header.shape().empty())
+        {
+            throw npy_array_exception{npy_array_exception_type::unsupported_layout};
+        }
+
+        if(_headers.empty())
+        {
+            _row_shape.assign(header.shape().cbegin() + 1, header.shape().cend());
+        }
+        else if(!std::equal(header.shape().cbegin() + 1, header.shape().cend(), _row_shape.cbegin(), _row_shape.cend()))
+        {
+            throw npy_array_exception{npy_array_exception_type::unmatched_shape_data};
+        }
+
+        _first_rows.push_back(_first_rows.back() + header.shape()[0]);
+        _headers.push_back(header);
+    }
+
+    _row_size = std::accumulate(_row_shape.cbegin(), _row_shape.cend(), size_type(1), std::multiplies<size_type>());
+    _shape.push_back(_first_rows.back());
+    _shape.insert(_shape.end(), _row_shape.cbegin(), _row_shape.cend());
+}
+
+template<typename T> const std::vector<size_t>& npy_sharded_array<T>::shape() const noexcept {return _shape;}
+template<typename T> size_t npy_sharded_array<T>::size() const noexcept {return _first_rows.back() * _row_size;}
+template<typename T> size_t npy_sharded_array<T>::rows() const noexcept {return _first_rows.back();}
+template<typename T> size_t npy_sharded_array<T>::row_size() const noexcept {return _row_size;}
+template<typename T> size_t npy_sharded_array<T>::shard_count() const noexcept {return _paths.size();}
+
+template<typename T>
+const std::string& npy_sharded_array<T>::shard_path(size_type shard) const
+{
+    if(shard >= _paths.size()) throw std::out_of_range{"Shard " + std::to_string(shard) + " is out of range " + std::to_string(_paths.size())};
+
+    return _paths[shard];
+}
+
+template<typename T>
+const npy_header& npy_sharded_array<T>::shard_header(size_type shard) const
+{
+    if(shard >= _paths.size()) throw std::out_of_range{"Shard " + std::to_string(shard) + " is out of range " + std::to_string(_paths.size())};
+
+    return _headers[shard];
+}
+
+template<typename T>
+size_t npy_sharded_array<T>::shard_first_row(size_type shard) const
+{
+    if(shard >= _paths.size()) throw std::out_of_range{"Shard " + std::to_string(shard) + " is out of range " + std::to_string(_paths.size())};
+
+    return _first_rows[shard];
+}
+
+template<typename T>
+std::pair<size_t, size_t> npy_sharded_array<T>::locate(size_type row) const
+{
+    if(row >= this->rows()) throw std::out_of_range{"Row " + std::to_string(row) + " is out of range " + std::to_string(this->rows())};
+
+    // The last shard whose first row is not after the row.
+    const size_type shard = std::upper_bound(_first_rows.cbegin(), _first_rows.cend(), row) - _first_rows.cbegin() - 1;
+
+    return std::make_pair(shard, row - _first_rows[shard]);
+}
+
+template<typename T>
+std::shared_ptr<const npy_array<T>> npy_sharded_array<T>::shard(size_type shard) const
+{
+    if(shard >= _paths.size()) throw std::out_of_range{"Shard " + std::to_string(shard) + " is out of range " + std::to_string(_paths.size())};
+
+    {
+        std::lock_guard<std::mutex> lock{_cache->mutex};
+        auto position = _cache->positions.find(shard);
+
+        if(position != _cache->positions.end())
+        {
+            _cache->shards.splice(_cache->shards.begin(), _cache->shards, position->second);
+            return position->second->second;
+        }
+    }
+
+    // The shard is opened without holding the lock, so that the other shards can be used meanwhile.
+    const npy_array_mode mode = _headers[shard].dtype() == npy_dtype::from_type<T>() ? npy_array_mode::map_read_only : npy_array_mode::load_in_memory;
+    std::shared_ptr<const npy_array<T>> array = std::make_shared<const npy_array<T>>(_paths[shard], mode);
+
+    if(array->shape() != _headers[shard].shape())
+    {
+        throw npy_array_exception{npy_array_exception_type::unmatched_shape_data};
+    }
+
+    std::lock_guard<std::mutex> lock{_cache->mutex};
+    auto position = _cache->positions.find(shard);
+
+    // Another thread opened it first.
+    if(position != _cache->positions.end())
+    {
+        _cache->shards.splice(_cache->shards.begin(), _cache->shards, position->second);
+        return position->second->second;
+    }
+
+    if(_cache->shards.size() == _max_open_shards)
+    {
+        _cache->positions.erase(_cache->shards.back().first);
+        _cache->shards.pop_back();
+    }
+
+    _cache->shards.emplace_front(shard, array);
+    _cache->positions.emplace(shard, _cache->shards.begin());
+
+    return array;
+}
+
+template<typename T>
+size_t npy_sharded_array<T>::open_shards() const
+{
+    std::lock_guard<std::mutex> lock{_cache->mutex};
+
+    return _cache->shards.size();
+}
+
+template<typename T>
+npy_view<const T> npy_sharded_array<T>::row_view(const npy_array<T>& rows, size_type row) const
+{
+    return npy_view<const T>{rows.data(), static_cast<ptrdiff_t>(row * _row_size), _row_shape, npy_view_strides(_row_shape, false)};
+}
+
+template<typename T>
+bool npy_sharded_array<T>::native(size_type shard) const noexcept
+{
+    return _headers[shard].dtype() == npy_dtype::from_type<T>();
+}
+
+template<typename T>
+void npy_sharded_array<T>::read_rows(size_type first_row, size_type row_count, T* destination, npy_thread_pool& pool) const
+{
+    const size_type row_bytes = _row_size * sizeof(T);
+    char* bytes = reinterpret_cast<char*>(destination);
+
+    if(row_bytes == 0) return;
+
+    for(size_type row = first_row, last_row = first_row + row_count; row < last_row;)
+    {
+        const std::pair<size_type, size_type> location = this->locate(row);
+        const npy_header& header = _headers[location.first];
+        const size_type count = std::min(last_row, _first_rows[location.first + 1]) - row;
+
+        std::function<void(char*, size_t)> swap{};
+
+        if(!this->native(location.first))
+        {
+            const npy_dtype file_dtype = header.dtype();
+
+            swap = [file_dtype](char* data, size_t length)
+            {
+                npy_byteswap(data, length / sizeof(T), file_dtype);
+            };
+        }
+
+        npy_parallel_read(_paths[location.first], header.payload_offset() + location.second * row_bytes, bytes, count * row_bytes,
+                          pool, npy_parallel_chunk_size, swap);
+
+        bytes += count * row_bytes;
+        row += count;
+    }
+}
+
+template<typename T>
+npy_array<T> npy_sharded_array<T>::row(size_type row) const
+{
+    const std::pair<size_type, size_type> location = this->locate(row);
+    npy_array<T> copied = npy_array<T>::uninitialized(_row_shape);
+
+    // A shard in the opposite byte order is not loaded whole for a single row, the row is read and swapped.
+    if(!this->native(location.first))
+    {
+        this->read_rows(row, 1, copied.data(), npy_thread_pool::shared());
+        return copied;
+    }
+
+    std::shared_ptr<const npy_array<T>> array = this->shard(location.first);
+    std::copy(array->data() + location.second * _row_size, array->data() + (location.second + 1) * _row_size, copied.data());
+
+    return copied;
+}
+
+template<typename T>
+npy_array<T> npy_sharded_array<T>::load_rows(size_type first_row, size_type row_count, npy_thread_pool& pool) const
+{
+    if(first_row > this->rows() || row_count > this->rows() - first_row)
+    {
+        throw std::out_of_range{"The rows from " + std::to_string(first_row) + " to " + std::to_string(first_row + row_count) + " are out of range " + std::to_string(this->rows())};
+    }
+
+    std::vector<size_type> shape{_shape};
+    shape[0] = row_count;
+
+    npy_array<T> array = npy_array<T>::uninitialized(shape);
+    this->read_rows(first_row, row_count, array.data(), pool);
+
+    return array;
+}
+
+template<typename T>
+typename npy_sharded_array<T>::const_iterator npy_sharded_array<T>::begin() const
+{
+    return const_iterator{this, 0};
+}
+
+template<typename T>
+typename npy_sharded_array<T>::const_iterator npy_sharded_array<T>::end() const
+{
+    return const_iterator{this, this->rows()};
+}
+
+template<typename T>
+npy_sharded_array<T>::const_iterator::const_iterator(const npy_sharded_array<T>* array, size_type row)
+    : _array{array}, _row{row}, _block{}, _block_first_row{0}, _block_rows{0}
+{
+}
+
+template<typename T>
+typename npy_sharded_array<T>::const_iterator::reference npy_sharded_array<T>::const_iterator::operator*() const
+{
+    if(!_block)
+    {
+        const std::pair<size_type, size_type> location = _array->locate(_row);
+
+        if(_array->native(location.first))
+        {
+            _block = _array->shard(location.first);
+            _block_first_row = _array->_first_rows[location.first];
+            _block_rows = _block->shape()[0];
+        }
+        else
+        {
+            // A shard in the opposite byte order is read and swapped in blocks of rows, instead of being loaded whole.
+            const size_type block_rows = std::max(size_type(1), npy_parallel_chunk_size / std::max(size_type(1), _array->_row_size * sizeof(T)));
+            const size_type count = std::min(block_rows, _array->_first_rows[location.first + 1] - _row);
+
+            std::vector<size_type> shape{_array->_shape};
+            shape[0] = count;
+
+            std::shared_ptr<npy_array<T>> block = std::make_shared<npy_array<T>>(npy_array<T>::uninitialized(shape));
+            _array->read_rows(_row, count, block->data(), npy_thread_pool::shared());
+
+            _block = std::move(block);
+            _block_first_row = _row;
+            _block_rows = count;
+        }
+    }
+
+    return _array->row_view(*_block, _row - _block_first_row);
+}
+
+template<typename T>
+typename npy_sharded_array<T>::const_iterator& npy_sharded_array<T>::const_iterator::operator++()
+{
+    _row++;
+
+    // Release the block once its last row is passed, closing its shard if the array did.
+    if(_block && _row == _block_first_row + _block_rows)
+    {
+        _block.reset();
+    }
+
+    return *this;
+}
+
+template<typename T>
+typename npy_sharded_array<T>::const_iterator npy_sharded_array<T>::const_iterator::operator++(int)
+{
+    const_iterator previous{*this};
+    ++(*this);
+
+    return previous;
+}
@@ -0,0 +1,125 @@
+#include "npy_array/npy_stream_reader.h"
+
+#include <functional>
+#include <numeric>
+
+template<typename T>
+npy_stream_reader<T>::npy_stream_reader(const std::string& array_path, size_type chunk_rows, bool read_ahead)
+    : _array_file{}, _header{}, _rows{0}, _row_size{0}, _max_chunk_rows{chunk_rows}, _read_ahead{read_ahead},
+      _buffer{}, _back_buffer{}, _chunk_rows{0}, _first_row{0}, _next_row{0}, _read_row{0}, _pending_read{}
+{
+    _array_file.exceptions(std::ifstream::failbit | std::ifstream::badbit | std::ifstream::eofbit);
+
+    try
+    {
+        _array_file.open(array_path, std::ios_base::in | std::ios_base::binary);
+
+        _header = npy_header::read(_array_file);
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    // A payload having the opposite byte order of the machine is swapped chunk by chunk.
+    if(_header.dtype().with_byte_order(npy_endianness::native) != npy_dtype::from_type<T>())
+    {
+        throw npy_array_exception{npy_array_exception_type::ill_formed_header};
+    }
+
+    // The rows of a Fortran ordered array are not contiguous in the file.
+    if(_header.fortran_order() && _header.shape().size() > 1)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_layout};
+    }
+
+    if(_max_chunk_rows == 0)
+    {
+        throw npy_array_exception{npy_array_exception_type::generic};
+    }
+
+    // A 0-d array is streamed as a single row of a single element.
+    const std::vector<size_type>& shape = _header.shape();
+    _rows = shape.empty() ? 1 : shape[0];
+    _row_size = std::accumulate(shape.cbegin() + (shape.empty() ? 0 : 1), shape.cend(), size_type(1), std::multiplies<size_type>());
+    _max_chunk_rows = std::min(_max_chunk_rows, _rows);
+
+    try
+    {
+        _buffer.resize(_max_chunk_rows * _row_size);
+
+        // An empty array has no chunk to read ahead.
+        if(_read_ahead && _rows > 0)
+        {
+            _back_buffer.resize(_buffer.size());
+            _pending_read = std::async(std::launch::async, &npy_stream_reader::read_chunk, this, std::ref(_back_buffer));
+        }
+    }
+    catch(const std::bad_alloc& bad_alloc_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+    }
+}
+
+template<typename T>
+typename npy_stream_reader<T>::size_type npy_stream_reader<T>::read_chunk(std::vector<storage_type>& buffer)
+{
+    size_type rows = std::min(_max_chunk_rows, _rows - _read_row);
+
+    try
+    {
+        _array_file.read(reinterpret_cast<char*>(buffer.data()), rows * _row_size * sizeof(T));
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    if(_header.dtype() != npy_dtype::from_type<T>())
+    {
+        npy_byteswap(buffer.data(), rows * _row_size, _header.dtype());
+    }
+
+    _read_row += rows;
+
+    return rows;
+}
+
+template<typename T>
+bool npy_stream_reader<T>::next()
+{
+    if(_read_ahead)
+    {
+        if(!_pending_read.valid()) return false;
+
+        // Wait for the chunk read in background, then start reading the following one into the buffer just released.
+        _chunk_rows = _pending_read.get();
+        std::swap(_buffer, _back_buffer);
+
+        if(_read_row < _rows)
+        {
+            _pending_read = std::async(std::launch::async, &npy_stream_reader::read_chunk, this, std::ref(_back_buffer));
+        }
+    }
+    else
+    {
+        if(_read_row == _rows) return false;
+
+        _chunk_rows = this->read_chunk(_buffer);
+    }
+
+    _first_row = _next_row;
+    _next_row += _chunk_rows;
+
+    return true;
+}
+
+template<typename T> const npy_header& npy_stream_reader<T>::header() const noexcept {return _header;}
+template<typename T> size_t npy_stream_reader<T>::rows() const noexcept {return _rows;}
+template<typename T> size_t npy_stream_reader<T>::row_size() const noexcept {return _row_size;}
+
+template<typename T> const T* npy_stream_reader<T>::data() const noexcept {return reinterpret_cast<const T*>(_buffer.data());}
+template<typename T> T* npy_stream_reader<T>::data() noexcept {return reinterpret_cast<T*>(_buffer.data());}
+template<typename T> size_t npy_stream_reader<T>::chunk_rows() const noexcept {return _chunk_rows;}
+template<typename T> size_t npy_stream_reader<T>::chunk_size() const noexcept {return _chunk_rows * _row_size;}
+template<typename T> size_t npy_stream_reader<T>::first_row() const noexcept {return _first_row;}
@@ -0,0 +1,158 @@
+#include "npy_array/npy_stream_writer.h"
+
+template<typename T>
+npy_stream_writer<T>::npy_stream_writer(const std::string& array_path, const std::vector<size_type>& row_shape, size_type buffer_size)
+    : _array_file{}, _row_shape{row_shape}, _row_size{0}, _rows{0}, _preamble_size{0}, _buffer{}, _buffer_used{0}
+{
+    if(!npy_dtype::from_type<T>())
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_dtype};
+    }
+
+    _row_size = std::accumulate(_row_shape.cbegin(), _row_shape.cend(), size_type(1), std::multiplies<size_type>());
+
+    // Reserve the preamble for the largest number of rows, so that the actual one always fits when patched by close().
+    npy_header largest_header{npy_dtype::from_type<T>(), false, this->shape(std::numeric_limits<size_type>::max())};
+    std::string preamble = largest_header.str();
+    _preamble_size = preamble.size();
+
+    try
+    {
+        _buffer.resize(std::max(buffer_size, sizeof(T)));
+    }
+    catch(const std::bad_alloc& bad_alloc_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+    }
+
+    _array_file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+
+    try
+    {
+        _array_file.open(array_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        // Write a placeholder preamble, it already describes a valid empty array.
+        preamble = npy_header{npy_dtype::from_type<T>(), false, this->shape(0)}.str(_preamble_size);
+        _array_file.write(preamble.data(), preamble.size());
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+}
+
+template<typename T>
+npy_stream_writer<T>::~npy_stream_writer()
+{
+    try
+    {
+        this->close();
+    }
+    catch(const npy_array_exception& npy_exception)
+    {
+        // Destructors must not throw, call close() explicitly to be notified of the errors.
+    }
+}
+
+template<typename T>
+std::vector<size_t> npy_stream_writer<T>::shape(size_type rows) const
+{
+    std::vector<size_type> array_shape{rows};
+    array_shape.insert(array_shape.end(), _row_shape.cbegin(), _row_shape.cend());
+    return array_shape;
+}
+
+template<typename T>
+void npy_stream_writer<T>::flush_buffer()
+{
+    try
+    {
+        _array_file.write(_buffer.data(), _buffer_used);
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    _buffer_used = 0;
+}
+
+template<typename T>
+void npy_stream_writer<T>::append(const T* rows_data, size_type rows)
+{
+    if(!_array_file.is_open())
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    const char* bytes = reinterpret_cast<const char*>(rows_data);
+    size_type byte_size = rows * _row_size * sizeof(T);
+
+    if(_buffer_used + byte_size > _buffer.size())
+    {
+        this->flush_buffer();
+    }
+
+    if(byte_size >= _buffer.size())
+    {
+        // A batch larger than the buffer is written directly, without copying it.
+        try
+        {
+            _array_file.write(bytes, byte_size);
+        }
+        catch(const std::ios_base::failure& failure_exception)
+        {
+            throw npy_array_exception{npy_array_exception_type::input_output_error};
+        }
+    }
+    else
+    {
+        std::copy(bytes, bytes + byte_size, _buffer.begin() + _buffer_used);
+        _buffer_used += byte_size;
+    }
+
+    _rows += rows;
+}
+
+template<typename T>
+void npy_stream_writer<T>::append(const npy_array<T>& rows)
+{
+    const std::vector<size_type>& shape = rows.shape();
+
+    if(shape.size() != _row_shape.size() + 1 || !std::equal(_row_shape.cbegin(), _row_shape.cend(), std::next(shape.cbegin())))
+    {
+        throw npy_array_exception{npy_array_exception_type::unmatched_shape_data};
+    }
+
+    if(rows.fortran_order() && shape.size() > 1)
+    {
+        throw npy_array_exception{npy_array_exception_type::unsupported_layout};
+    }
+
+    this->append(rows.data(), shape[0]);
+}
+
+template<typename T>
+void npy_stream_writer<T>::close()
+{
+    if(!_array_file.is_open()) return;
+
+    this->flush_buffer();
+
+    try
+    {
+        // Patch the preamble with the actual number of rows, padding it to the size reserved at construction.
+        std::string preamble = npy_header{npy_dtype::from_type<T>(), false, this->shape(_rows)}.str(_preamble_size);
+        _array_file.seekp(0);
+        _array_file.write(preamble.data(), preamble.size());
+        _array_file.close();
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+}
+
+template<typename T> const std::vector<size_t>& npy_stream_writer<T>::row_shape() const noexcept {return _row_shape;}
+template<typename T> size_t npy_stream_writer<T>::row_size() const noexcept {return _row_size;}
+template<typename T> size_t npy_stream_writer<T>::rows() const noexcept {return _rows;}
+template<typename T> bool npy_stream_writer<T>::is_open() const noexcept {return _array_file.is_open();}
@@ -0,0 +1,132 @@
+#include "npy_array/npy_thread_pool.h"
+
+#include <algorithm>
+
+// The number of workers of the I/O pool, the tasks mostly wait for the storage so they do not compete for the cores.
+const size_t io_pool_threads = 4;
+
+// The pool whose worker is running on the current thread, null on the other threads.
+thread_local npy_thread_pool* current_pool = nullptr;
+
+npy_thread_pool::npy_thread_pool(size_t threads)
+    : _workers{}, _tasks{}, _mutex{}, _condition{}, _stopping{false}
+{
+    if(threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    _workers.reserve(threads);
+
+    for(size_t i = 0; i < threads; i++)
+    {
+        _workers.emplace_back(&npy_thread_pool::work, this);
+    }
+}
+
+npy_thread_pool::~npy_thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stopping = true;
+    }
+
+    _condition.notify_all();
+
+    for(auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+size_t npy_thread_pool::size() const noexcept {return _workers.size();}
+
+void npy_thread_pool::work()
+{
+    current_pool = this;
+
+    while(true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _condition.wait(lock, [this](){return _stopping || !_tasks.empty();});
+
+            // The pending tasks are drained before stopping.
+            if(_tasks.empty()) return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+void npy_thread_pool::parallel_for(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body)
+{
+    if(begin >= end) return;
+
+    // A worker waiting for ranges queued on its own pool could deadlock it, so it runs them all by itself.
+    if(current_pool == this)
+    {
+        body(begin, end);
+        return;
+    }
+
+    size_t ranges = std::min(end - begin, _workers.size());
+    size_t range_size = (end - begin + ranges - 1) / ranges;
+
+    std::vector<std::future<void>> results{};
+    results.reserve(ranges);
+
+    size_t range_begin = begin;
+
+    for(; range_begin + range_size < end; range_begin += range_size)
+    {
+        size_t range_end = range_begin + range_size;
+        results.push_back(this->submit([&body, range_begin, range_end](){body(range_begin, range_end);}));
+    }
+
+    std::exception_ptr first_exception{};
+
+    try
+    {
+        body(range_begin, end);
+    }
+    catch(...)
+    {
+        first_exception = std::current_exception();
+    }
+
+    // Every range must complete before returning, since they refer to the caller's data.
+    for(auto& result : results)
+    {
+        try
+        {
+            result.get();
+        }
+        catch(...)
+        {
+            if(!first_exception) first_exception = std::current_exception();
+        }
+    }
+
+    if(first_exception)
+    {
+        std::rethrow_exception(first_exception);
+    }
+}
+
+npy_thread_pool& npy_thread_pool::shared()
+{
+    static npy_thread_pool shared_pool{};
+    return shared_pool;
+}
+
+npy_thread_pool& npy_thread_pool::io()
+{
+    static npy_thread_pool io_pool{io_pool_threads};
+    return io_pool;
+}
@@ -0,0 +1,81 @@
+#include "npy_array/npy_transpose.h"
+
+#include <algorithm>
+
+// The side of the square tiles, 32 x 32 elements of 8 bytes use 8 KiB for each of source and destination.
+const size_t transpose_tile_size = 32;
+
+template<typename T>
+void npy_fortran_to_c_order(const T* source, T* destination, const std::vector<size_t>& shape, npy_thread_pool& pool)
+{
+    size_t size = 1;
+    for(size_t dimension : shape) size *= dimension;
+
+    // With less than two dimensions both orders coincide.
+    if(shape.size() < 2 || size == 0)
+    {
+        std::copy(source, source + size, destination);
+        return;
+    }
+
+    const size_t dimensions = shape.size();
+    const size_t rows = shape.front();
+    const size_t columns = shape.back();
+
+    // Fortran strides grow from the first axis, C strides from the last one.
+    std::vector<size_t> fortran_strides(dimensions), c_strides(dimensions);
+    fortran_strides[0] = 1;
+    c_strides[dimensions - 1] = 1;
+
+    for(size_t i = 1; i < dimensions; i++)
+    {
+        fortran_strides[i] = fortran_strides[i - 1] * shape[i - 1];
+        c_strides[dimensions - 1 - i] = c_strides[dimensions - i] * shape[dimensions - i];
+    }
+
+    const size_t source_column_stride = fortran_strides[dimensions - 1];
+    const size_t destination_row_stride = c_strides[0];
+
+    // A work item is a band of tile_size rows of one 2-d slice, identified by the middle indexes.
+    const size_t slices = size / (rows * columns);
+    const size_t bands = (rows + transpose_tile_size - 1) / transpose_tile_size;
+
+    pool.parallel_for(0, slices * bands, [&](size_t begin, size_t end)
+    {
+        for(size_t item = begin; item < end; item++)
+        {
+            size_t slice = item / bands;
+            size_t row_begin = (item % bands) * transpose_tile_size;
+            size_t row_end = std::min(row_begin + transpose_tile_size, rows);
+
+            // Decompose the slice index over the middle axes, the last middle axis varying fastest.
+            size_t source_offset = 0;
+            size_t destination_offset = 0;
+
+            for(size_t i = dimensions - 1; i > 1; i--)
+            {
+                size_t index = slice % shape[i - 1];
+                slice /= shape[i - 1];
+                source_offset += index * fortran_strides[i - 1];
+                destination_offset += index * c_strides[i - 1];
+            }
+
+            for(size_t column_begin = 0; column_begin < columns; column_begin += transpose_tile_size)
+            {
+                size_t column_end = std::min(column_begin + transpose_tile_size, columns);
+
+                // Source reads are contiguous along the rows, destination writes along the columns.
+                for(size_t row = row_begin; row < row_end; row++)
+                {
+                    const T* source_row = source + source_offset + row;
+                    T* destination_row = destination + destination_offset + row * destination_row_stride;
+
+                    for(size_t column = column_begin; column < column_end; column++)
+                    {
+                        destination_row[column] = source_row[column * source_column_stride];
+                    }
+                }
+            }
+        }
+    });
+}
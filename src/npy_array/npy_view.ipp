@@ -0,0 +1,297 @@
+#include "npy_array/npy_view.h"
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+// The strides in elements of a payload stored in C or Fortran order.
+inline std::vector<ptrdiff_t> npy_view_strides(const std::vector<size_t>& shape, bool fortran_order)
+{
+    std::vector<ptrdiff_t> strides(shape.size());
+    ptrdiff_t stride = 1;
+
+    for(size_t i = 0; i < shape.size(); i++)
+    {
+        size_t axis = fortran_order ? i : shape.size() - 1 - i;
+        strides[axis] = stride;
+        stride *= static_cast<ptrdiff_t>(shape[axis]);
+    }
+
+    return strides;
+}
+
+template<typename T>
+template<typename U, typename Allocator>
+npy_view<T>::npy_view(npy_array<U, Allocator>& array)
+    : _base{array.data()}, _offset{0}, _shape{array.shape()}, _strides{npy_view_strides(array.shape(), array.fortran_order())}
+{
+}
+
+template<typename T>
+template<typename U, typename Allocator>
+npy_view<T>::npy_view(const npy_array<U, Allocator>& array)
+    : _base{array.data()}, _offset{0}, _shape{array.shape()}, _strides{npy_view_strides(array.shape(), array.fortran_order())}
+{
+}
+
+template<typename T>
+npy_view<T>::npy_view(T* base, stride_type offset, std::vector<size_type> shape, std::vector<stride_type> strides)
+    : _base{base}, _offset{offset}, _shape{std::move(shape)}, _strides{std::move(strides)}
+{
+    if(_shape.size() != _strides.size())
+    {
+        throw std::invalid_argument{"The shape has " + std::to_string(_shape.size()) + " axes but there are " + std::to_string(_strides.size()) + " strides"};
+    }
+}
+
+template<typename T>
+void npy_view<T>::check_axis(size_type axis) const
+{
+    if(axis >= _shape.size())
+    {
+        throw std::invalid_argument{"The axis " + std::to_string(axis) + " does not exist in a view of " + std::to_string(_shape.size()) + " axes"};
+    }
+}
+
+template<typename T>
+void npy_view<T>::narrow(size_type axis, const npy_slice& range)
+{
+    if(range.step == 0)
+    {
+        throw std::invalid_argument{"The step of the slice of the axis " + std::to_string(axis) + " is zero"};
+    }
+
+    const stride_type length = static_cast<stride_type>(_shape[axis]);
+
+    // Negative bounds count from the end, then the bounds are clamped to the indexes the step can reach.
+    auto bound = [length](stride_type value, stride_type lowest, stride_type highest)
+    {
+        if(value < 0) value += length;
+        return std::min(std::max(value, lowest), highest);
+    };
+
+    stride_type start;
+    stride_type count;
+
+    if(range.step > 0)
+    {
+        start = range.start == npy_slice_none ? 0 : bound(range.start, 0, length);
+        stride_type stop = range.stop == npy_slice_none ? length : bound(range.stop, 0, length);
+        count = stop > start ? (stop - start + range.step - 1) / range.step : 0;
+    }
+    else
+    {
+        start = range.start == npy_slice_none ? length - 1 : bound(range.start, -1, length - 1);
+        stride_type stop = range.stop == npy_slice_none ? -1 : bound(range.stop, -1, length - 1);
+        count = start > stop ? (start - stop - range.step - 1) / -range.step : 0;
+    }
+
+    if(count > 0)
+    {
+        _offset += start * _strides[axis];
+    }
+
+    _shape[axis] = static_cast<size_type>(count);
+    _strides[axis] *= range.step;
+}
+
+template<typename T>
+npy_view<T> npy_view<T>::slice(std::initializer_list<npy_slice> slices) const
+{
+    if(slices.size() > _shape.size())
+    {
+        throw std::invalid_argument{"There are " + std::to_string(slices.size()) + " slices for a view of " + std::to_string(_shape.size()) + " axes"};
+    }
+
+    npy_view view{*this};
+    size_type axis = 0;
+
+    for(const npy_slice& range : slices)
+    {
+        view.narrow(axis++, range);
+    }
+
+    return view;
+}
+
+template<typename T>
+npy_view<T> npy_view<T>::slice(size_type axis, const npy_slice& range) const
+{
+    this->check_axis(axis);
+
+    npy_view view{*this};
+    view.narrow(axis, range);
+
+    return view;
+}
+
+template<typename T>
+npy_view<T> npy_view<T>::select(size_type axis, size_type index) const
+{
+    this->check_axis(axis);
+
+    if(index >= _shape[axis])
+    {
+        throw std::out_of_range{"Index " + std::to_string(index) + " is out of range " + std::to_string(_shape[axis]) + " of the axis " + std::to_string(axis)};
+    }
+
+    npy_view view{*this};
+    view._offset += static_cast<stride_type>(index) * _strides[axis];
+    view._shape.erase(view._shape.begin() + axis);
+    view._strides.erase(view._strides.begin() + axis);
+
+    return view;
+}
+
+template<typename T>
+npy_view<T> npy_view<T>::transpose() const
+{
+    return npy_view{_base, _offset, std::vector<size_type>(_shape.rbegin(), _shape.rend()), std::vector<stride_type>(_strides.rbegin(), _strides.rend())};
+}
+
+template<typename T>
+npy_view<T> npy_view<T>::transpose(const std::vector<size_type>& axes) const
+{
+    if(axes.size() != _shape.size())
+    {
+        throw std::invalid_argument{"There are " + std::to_string(axes.size()) + " axes for a view of " + std::to_string(_shape.size()) + " axes"};
+    }
+
+    std::vector<bool> taken(axes.size(), false);
+    std::vector<size_type> shape(axes.size());
+    std::vector<stride_type> strides(axes.size());
+
+    for(size_type i = 0; i < axes.size(); i++)
+    {
+        if(axes[i] >= axes.size() || taken[axes[i]])
+        {
+            throw std::invalid_argument{"The axes are not a permutation of the axes of the view"};
+        }
+
+        taken[axes[i]] = true;
+        shape[i] = _shape[axes[i]];
+        strides[i] = _strides[axes[i]];
+    }
+
+    return npy_view{_base, _offset, std::move(shape), std::move(strides)};
+}
+
+template<typename T>
+bool npy_view<T>::contiguous() const noexcept
+{
+    if(this->size() == 0) return true;
+
+    stride_type stride = 1;
+
+    // The axes of a single index can have any stride.
+    for(size_type i = _shape.size(); i > 0; i--)
+    {
+        if(_shape[i - 1] != 1 && _strides[i - 1] != stride) return false;
+        stride *= static_cast<stride_type>(_shape[i - 1]);
+    }
+
+    return true;
+}
+
+template<typename T>
+npy_array<typename std::remove_const<T>::type> npy_view<T>::copy() const
+{
+    typedef typename std::remove_const<T>::type element_type;
+
+    npy_array<element_type> array = npy_array<element_type>::uninitialized(_shape);
+    element_type* destination = array.data();
+
+    if(this->size() == 0) return array;
+
+    // The trailing axes laid out without gaps form blocks copied at once.
+    size_type block = 1;
+    size_type outer = _shape.size();
+
+    while(outer > 0 && (_shape[outer - 1] == 1 || _strides[outer - 1] == static_cast<stride_type>(block)))
+    {
+        block *= _shape[outer - 1];
+        outer--;
+    }
+
+    if(outer == 0)
+    {
+        std::copy(this->data(), this->data() + block, destination);
+        return array;
+    }
+
+    // The blocks along the innermost outer axis are copied in a loop, the other outer axes are walked with an odometer.
+    const size_type inner = outer - 1;
+    const T* source = this->data();
+    std::vector<size_type> indexes(inner, 0);
+
+    for(;;)
+    {
+        const T* run = source;
+
+        if(block == 1)
+        {
+            for(size_type i = 0; i < _shape[inner]; i++, run += _strides[inner])
+            {
+                *destination++ = *run;
+            }
+        }
+        else
+        {
+            for(size_type i = 0; i < _shape[inner]; i++, run += _strides[inner])
+            {
+                destination = std::copy(run, run + block, destination);
+            }
+        }
+
+        size_type axis = inner;
+
+        for(; axis > 0; axis--)
+        {
+            if(++indexes[axis - 1] < _shape[axis - 1])
+            {
+                source += _strides[axis - 1];
+                break;
+            }
+
+            source -= _strides[axis - 1] * static_cast<stride_type>(_shape[axis - 1] - 1);
+            indexes[axis - 1] = 0;
+        }
+
+        if(axis == 0) break;
+    }
+
+    return array;
+}
+
+template<typename T>
+T& npy_view<T>::operator[](std::initializer_list<size_type> indexes) const noexcept
+{
+    stride_type index = _offset;
+    auto stride = _strides.cbegin();
+
+    for(size_type value : indexes)
+    {
+        index += static_cast<stride_type>(value) * *stride++;
+    }
+
+    return _base[index];
+}
+
+template<typename T>
+T& npy_view<T>::at(std::initializer_list<size_type> indexes) const
+{
+    if(indexes.size() != _shape.size()) throw std::out_of_range{"The number of provided indexes " + std::to_string(indexes.size()) + " does not match the number of dimensions " + std::to_string(_shape.size())};
+
+    for(size_type i = 0; i < _shape.size(); i++)
+    {
+        if(*(indexes.begin() + i) >= _shape[i]) throw std::out_of_range{"Index " + std::to_string(*(indexes.begin() + i)) + " is out of range " + std::to_string(_shape[i]) + " of the axis " + std::to_string(i)};
+    }
+
+    return (*this)[indexes];
+}
+
+template<typename T> const std::vector<size_t>& npy_view<T>::shape() const noexcept {return _shape;}
+template<typename T> const std::vector<ptrdiff_t>& npy_view<T>::strides() const noexcept {return _strides;}
+template<typename T> ptrdiff_t npy_view<T>::offset() const noexcept {return _offset;}
+template<typename T> size_t npy_view<T>::size() const noexcept {return std::accumulate(_shape.cbegin(), _shape.cend(), size_t(1), std::multiplies<size_t>());}
+template<typename T> T* npy_view<T>::data() const noexcept {return _base + _offset;}
@@ -0,0 +1,418 @@
+#include "npy_array/npz_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <endian.h>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <streambuf>
+
+#include <zlib.h>
+
+namespace
+{
+    const uint32_t local_header_signature = 0x04034b50;
+    const uint32_t central_header_signature = 0x02014b50;
+    const uint32_t end_of_central_directory_signature = 0x06054b50;
+    const uint32_t zip64_locator_signature = 0x07064b50;
+    const uint32_t zip64_end_of_central_directory_signature = 0x06064b50;
+
+    const size_t local_header_size = 30;
+    const size_t central_header_size = 46;
+    const size_t end_of_central_directory_size = 22;
+    const size_t zip64_locator_size = 20;
+    const size_t zip64_end_of_central_directory_size = 56;
+
+    const uint16_t zip64_extra_field_id = 0x0001;
+    const uint16_t stored_method = 0;
+    const uint16_t deflated_method = 8;
+
+    // The prefix of a compressed member inflated to read its header, grown until the header fits.
+    const size_t header_prefix_size = 1024;
+
+    uint16_t read_le16(const char* data)
+    {
+        uint16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return le16toh(value);
+    }
+
+    uint32_t read_le32(const char* data)
+    {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return le32toh(value);
+    }
+
+    uint64_t read_le64(const char* data)
+    {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return le64toh(value);
+    }
+
+    // The zlib counters are 32 bits wide, so the CRC of a larger range is computed in slices.
+    uLong update_crc(uLong crc, const char* data, uint64_t size)
+    {
+        while(size > 0)
+        {
+            uInt slice = static_cast<uInt>(std::min<uint64_t>(size, std::numeric_limits<uInt>::max()));
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(data), slice);
+            data += slice;
+            size -= slice;
+        }
+
+        return crc;
+    }
+
+    // A read-only seekable stream buffer over a memory range, used to read headers out of the mapping.
+    class memory_buffer : public std::streambuf
+    {
+    public:
+        memory_buffer(const char* data, size_t size)
+        {
+            char* begin = const_cast<char*>(data);
+            this->setg(begin, begin, begin + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override
+        {
+            char* base = direction == std::ios_base::beg ? this->eback() : (direction == std::ios_base::cur ? this->gptr() : this->egptr());
+
+            if(offset < this->eback() - base || offset > this->egptr() - base)
+            {
+                return pos_type(off_type(-1));
+            }
+
+            this->setg(this->eback(), base + offset, this->egptr());
+
+            return pos_type(this->gptr() - this->eback());
+        }
+
+        pos_type seekpos(pos_type position, std::ios_base::openmode mode) override
+        {
+            return this->seekoff(off_type(position), std::ios_base::beg, mode);
+        }
+    };
+
+    // A raw deflate stream over the data of a member, inflated sequentially into caller buffers.
+    class inflate_stream
+    {
+    public:
+        inflate_stream(const char* input, uint64_t input_size)
+            : _stream{}, _input{input}, _remaining_input{input_size}, _crc32{crc32(0, Z_NULL, 0)}
+        {
+            if(inflateInit2(&_stream, -MAX_WBITS) != Z_OK)
+            {
+                throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+            }
+        }
+
+        inflate_stream(const inflate_stream& other) = delete;
+        inflate_stream& operator=(const inflate_stream& other) = delete;
+
+        ~inflate_stream()
+        {
+            inflateEnd(&_stream);
+        }
+
+        // Inflate exactly size bytes into output.
+        void read(char* output, size_t size)
+        {
+            while(size > 0)
+            {
+                // The zlib counters are 32 bits wide, so both sides are fed in slices.
+                if(_stream.avail_in == 0)
+                {
+                    uInt input_slice = static_cast<uInt>(std::min<uint64_t>(_remaining_input, std::numeric_limits<uInt>::max()));
+                    _stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(_input));
+                    _stream.avail_in = input_slice;
+                    _input += input_slice;
+                    _remaining_input -= input_slice;
+                }
+
+                uInt output_slice = static_cast<uInt>(std::min<size_t>(size, std::numeric_limits<uInt>::max()));
+                _stream.next_out = reinterpret_cast<Bytef*>(output);
+                _stream.avail_out = output_slice;
+
+                int result = inflate(&_stream, Z_NO_FLUSH);
+                size_t produced = output_slice - _stream.avail_out;
+
+                _crc32 = crc32(_crc32, reinterpret_cast<const Bytef*>(output), static_cast<uInt>(produced));
+                output += produced;
+                size -= produced;
+
+                bool starved = result == Z_BUF_ERROR && _stream.avail_in == 0 && _remaining_input == 0;
+
+                if((result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) || starved || (result == Z_STREAM_END && size > 0))
+                {
+                    throw npy_array_exception{npy_array_exception_type::invalid_archive};
+                }
+            }
+        }
+
+        uLong crc() const noexcept {return _crc32;}
+
+    private:
+        z_stream _stream;
+        const char* _input;
+        uint64_t _remaining_input;
+        uLong _crc32;
+    };
+}
+
+npz_archive::npz_archive(const std::string& archive_path)
+    : _mapping{std::make_shared<npy_mapping>(archive_path, false)}, _members{}, _indexes{}
+{
+    this->read_central_directory();
+}
+
+void npz_archive::read_central_directory()
+{
+    const char* archive = _mapping->data();
+    const uint64_t archive_size = _mapping->size();
+
+    if(archive_size < end_of_central_directory_size)
+    {
+        throw npy_array_exception{npy_array_exception_type::invalid_archive};
+    }
+
+    // The end of central directory record is the last record of the archive, followed only by a comment of at most 65535 bytes.
+    uint64_t end_offset = archive_size - end_of_central_directory_size;
+    uint64_t search_limit = end_offset > 0xFFFF ? end_offset - 0xFFFF : 0;
+
+    while(read_le32(archive + end_offset) != end_of_central_directory_signature)
+    {
+        if(end_offset == search_limit)
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        end_offset--;
+    }
+
+    uint64_t entries = read_le16(archive + end_offset + 10);
+    uint64_t directory_size = read_le32(archive + end_offset + 12);
+    uint64_t directory_offset = read_le32(archive + end_offset + 16);
+
+    // A ZIP64 archive is announced by a locator right before the end of central directory record.
+    if(end_offset >= zip64_locator_size && read_le32(archive + end_offset - zip64_locator_size) == zip64_locator_signature)
+    {
+        uint64_t zip64_end_offset = read_le64(archive + end_offset - zip64_locator_size + 8);
+
+        if(zip64_end_offset > archive_size - zip64_end_of_central_directory_size || read_le32(archive + zip64_end_offset) != zip64_end_of_central_directory_signature)
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        entries = read_le64(archive + zip64_end_offset + 32);
+        directory_size = read_le64(archive + zip64_end_offset + 40);
+        directory_offset = read_le64(archive + zip64_end_offset + 48);
+    }
+
+    if(directory_offset > archive_size || directory_size > archive_size - directory_offset)
+    {
+        throw npy_array_exception{npy_array_exception_type::invalid_archive};
+    }
+
+    const char* entry = archive + directory_offset;
+    const char* directory_end = entry + directory_size;
+
+    for(uint64_t i = 0; i < entries; i++)
+    {
+        if(static_cast<size_t>(directory_end - entry) < central_header_size || read_le32(entry) != central_header_signature)
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        uint16_t flags = read_le16(entry + 8);
+        uint16_t method = read_le16(entry + 10);
+        uint16_t name_length = read_le16(entry + 28);
+        uint16_t extra_length = read_le16(entry + 30);
+        uint16_t comment_length = read_le16(entry + 32);
+
+        if(static_cast<size_t>(directory_end - entry) < central_header_size + name_length + extra_length + comment_length)
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        npz_member member{};
+        member.name.assign(entry + central_header_size, name_length);
+        member.crc32 = read_le32(entry + 16);
+        member.compressed_size = read_le32(entry + 20);
+        member.uncompressed_size = read_le32(entry + 24);
+        uint64_t local_header_offset = read_le32(entry + 42);
+
+        // The 32 bits fields saturated to 0xFFFFFFFF are stored, in this order, in the ZIP64 extra field.
+        const char* extra = entry + central_header_size + name_length;
+        const char* extra_end = extra + extra_length;
+
+        while(extra_end - extra >= 4)
+        {
+            uint16_t field_id = read_le16(extra);
+            uint16_t field_size = read_le16(extra + 2);
+            const char* field = extra + 4;
+            const char* field_end = std::min(field + field_size, extra_end);
+
+            if(field_id == zip64_extra_field_id)
+            {
+                for(uint64_t* value : {&member.uncompressed_size, &member.compressed_size, &local_header_offset})
+                {
+                    if(*value == 0xFFFFFFFF && field_end - field >= 8)
+                    {
+                        *value = read_le64(field);
+                        field += 8;
+                    }
+                }
+            }
+
+            extra = field_end;
+        }
+
+        entry += central_header_size + name_length + extra_length + comment_length;
+
+        const std::string extension{".npy"};
+
+        if(member.name.size() <= extension.size() || member.name.compare(member.name.size() - extension.size(), extension.size(), extension) != 0)
+        {
+            continue;
+        }
+
+        member.name.erase(member.name.size() - extension.size());
+
+        // Encrypted members and compression methods other than deflate are not supported.
+        if((flags & 0x1) != 0 || (method != stored_method && method != deflated_method))
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        member.compressed = method == deflated_method;
+
+        if(local_header_offset > archive_size - local_header_size || read_le32(archive + local_header_offset) != local_header_signature)
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        // The local header has its own name and extra field, which may differ from the central directory ones.
+        member.data_offset = local_header_offset + local_header_size + read_le16(archive + local_header_offset + 26) + read_le16(archive + local_header_offset + 28);
+
+        if(member.data_offset > archive_size || member.compressed_size > archive_size - member.data_offset || (!member.compressed && member.compressed_size != member.uncompressed_size))
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        member.header = this->read_member_header(member);
+
+        if(member.header.payload_offset() > member.uncompressed_size || member.header.byte_size() > member.uncompressed_size - member.header.payload_offset())
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        _indexes[member.name] = _members.size();
+        _members.push_back(std::move(member));
+    }
+}
+
+npy_header npz_archive::read_member_header(const npz_member& member) const
+{
+    const char* data = _mapping->data() + member.data_offset;
+
+    if(!member.compressed)
+    {
+        memory_buffer buffer{data, member.uncompressed_size};
+        std::istream member_stream{&buffer};
+
+        return npy_header::read(member_stream);
+    }
+
+    // Only a prefix of a compressed member is inflated, and it is grown as long as the header does not fit.
+    uint64_t prefix_size = std::min<uint64_t>(header_prefix_size, member.uncompressed_size);
+
+    while(true)
+    {
+        std::string prefix(prefix_size, '\0');
+        inflate_stream stream{data, member.compressed_size};
+        stream.read(&prefix[0], prefix.size());
+
+        memory_buffer buffer{prefix.data(), prefix.size()};
+        std::istream member_stream{&buffer};
+
+        try
+        {
+            return npy_header::read(member_stream);
+        }
+        catch(const npy_array_exception& exception)
+        {
+            if(exception.exception_type() != npy_array_exception_type::input_output_error || prefix_size == member.uncompressed_size)
+            {
+                throw;
+            }
+        }
+
+        prefix_size = std::min<uint64_t>(prefix_size * 4, member.uncompressed_size);
+    }
+}
+
+void npz_archive::read_payload(const npz_member& member, char* destination) const
+{
+    const char* data = _mapping->data() + member.data_offset;
+    const size_type payload_offset = member.header.payload_offset();
+    const size_type payload_size = member.header.byte_size();
+
+    if(!member.compressed)
+    {
+        std::copy(data + payload_offset, data + payload_offset + payload_size, destination);
+
+        // Like for the deflated members, the CRC is checked only when the payload ends the array file.
+        if(payload_offset + payload_size == member.uncompressed_size && update_crc(crc32(0, Z_NULL, 0), data, member.uncompressed_size) != member.crc32)
+        {
+            throw npy_array_exception{npy_array_exception_type::invalid_archive};
+        }
+
+        return;
+    }
+
+    inflate_stream stream{data, member.compressed_size};
+
+    std::vector<char> preamble(payload_offset);
+    stream.read(preamble.data(), preamble.size());
+    stream.read(destination, payload_size);
+
+    // The CRC covers the whole array file, which is fully inflated only when nothing follows the payload.
+    if(payload_offset + payload_size == member.uncompressed_size && stream.crc() != member.crc32)
+    {
+        throw npy_array_exception{npy_array_exception_type::invalid_archive};
+    }
+}
+
+const std::vector<npz_member>& npz_archive::members() const noexcept {return _members;}
+npz_archive::size_type npz_archive::size() const noexcept {return _members.size();}
+
+std::vector<std::string> npz_archive::names() const
+{
+    std::vector<std::string> member_names{};
+    member_names.reserve(_members.size());
+
+    for(const auto& member : _members)
+    {
+        member_names.push_back(member.name);
+    }
+
+    return member_names;
+}
+
+bool npz_archive::contains(const std::string& name) const
+{
+    return _indexes.find(name) != _indexes.end();
+}
+
+const npz_member& npz_archive::member(const std::string& name) const
+{
+    auto index = _indexes.find(name);
+
+    if(index == _indexes.end()) throw std::out_of_range{"The archive has no member named " + name};
+
+    return _members[index->second];
+}
@@ -0,0 +1,49 @@
+#include "npy_array/npz_archive.h"
+
+template<typename T, typename Allocator>
+npy_array<T, Allocator> npz_archive::load(const std::string& name, npy_array_mode mode, const Allocator& allocator) const
+{
+    const npz_member& archive_member = this->member(name);
+    const npy_header& header = archive_member.header;
+
+    if(mode == npy_array_mode::map_read_write)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    if(header.dtype().with_byte_order(npy_endianness::native) != npy_dtype::from_type<T>())
+    {
+        throw npy_array_exception{npy_array_exception_type::ill_formed_header};
+    }
+
+    bool swap_bytes = header.dtype() != npy_dtype::from_type<T>();
+    size_type payload_offset = archive_member.data_offset + header.payload_offset();
+
+    // The members written by numpy are not aligned in the archive, only the aligned ones can be referred in place.
+    if(mode == npy_array_mode::map_read_only && !archive_member.compressed && !swap_bytes && payload_offset % alignof(T) == 0)
+    {
+        return npy_array<T, Allocator>{header.shape(), header.fortran_order(), _mapping, payload_offset, allocator};
+    }
+
+    npy_array<T, Allocator> array = npy_array<T, Allocator>::uninitialized(header.shape(), allocator);
+    this->read_payload(archive_member, reinterpret_cast<char*>(array.data()));
+
+    if(swap_bytes)
+    {
+        npy_byteswap(array.data(), array.size(), header.dtype());
+    }
+
+    if(header.fortran_order())
+    {
+        array._fortran_order = true;
+        array._strides.clear();
+        array.check_for_strides();
+
+        if(mode == npy_array_mode::load_c_order)
+        {
+            array.to_c_order();
+        }
+    }
+
+    return array;
+}
@@ -0,0 +1,409 @@
+#include "npy_array/npz_writer.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <endian.h>
+#include <zlib.h>
+
+namespace
+{
+    const uint32_t local_header_signature = 0x04034b50;
+    const uint32_t central_header_signature = 0x02014b50;
+    const uint32_t end_of_central_directory_signature = 0x06054b50;
+    const uint32_t zip64_locator_signature = 0x07064b50;
+    const uint32_t zip64_end_of_central_directory_signature = 0x06064b50;
+
+    const uint64_t zip32_limit = 0xFFFFFFFF;
+    const uint16_t zip32_count_limit = 0xFFFF;
+    const uint16_t zip64_extra_field_id = 0x0001;
+
+    const uint16_t stored_method = 0;
+    const uint16_t deflated_method = 8;
+
+    // Version 2.0 of the specification introduced deflate, version 4.5 ZIP64.
+    const uint16_t deflate_version = 20;
+    const uint16_t zip64_version = 45;
+
+    // Every member is dated 1980-01-01 00:00, the MS-DOS epoch, so that the archives are reproducible.
+    const uint16_t dos_time = 0x0000;
+    const uint16_t dos_date = 0x0021;
+
+    // Regular file readable by everyone, in the upper half of the external attributes.
+    const uint32_t external_attributes = 0100644u << 16;
+
+    // The host of "version made by", Unix, so that the readers interpret the external attributes as a Unix mode.
+    const uint16_t unix_host = 3 << 8;
+
+    // zlib sizes are 32 bits wide, so a chunk is at most 1 GiB.
+    const size_t maximum_chunk_size = size_t(1) << 30;
+
+    void append_le16(std::string& buffer, uint16_t value)
+    {
+        value = htole16(value);
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void append_le32(std::string& buffer, uint32_t value)
+    {
+        value = htole32(value);
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void append_le64(std::string& buffer, uint64_t value)
+    {
+        value = htole64(value);
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    uint32_t saturate(uint64_t value)
+    {
+        return static_cast<uint32_t>(std::min(value, zip32_limit));
+    }
+
+    // The chunk i of a member: the first one is the preamble, the following ones are slices of the payload.
+    void member_chunk(size_t i, const std::string& preamble, const char* payload, size_t payload_size, size_t chunk_size, const char*& data, size_t& size)
+    {
+        if(i == 0)
+        {
+            data = preamble.data();
+            size = preamble.size();
+        }
+        else
+        {
+            size_t offset = (i - 1) * chunk_size;
+            data = payload + offset;
+            size = std::min(chunk_size, payload_size - offset);
+        }
+    }
+
+    // Deflate a chunk on its own, terminating it with a sync flush so that it can be followed by the next chunk,
+    // or with the final block if it is the last one.
+    std::string deflate_chunk(const char* data, size_t size, int level, bool last)
+    {
+        z_stream stream{};
+
+        if(deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw npy_array_exception{npy_array_exception_type::unsufficient_memory};
+        }
+
+        // The bound covers a final block, a sync flush adds at most an empty stored block of 5 bytes.
+        std::string compressed(deflateBound(&stream, static_cast<uLong>(size)) + 16, '\0');
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream.avail_in = static_cast<uInt>(size);
+        stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+        stream.avail_out = static_cast<uInt>(compressed.size());
+
+        int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        bool complete = last ? result == Z_STREAM_END : (result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0);
+
+        compressed.resize(compressed.size() - stream.avail_out);
+        deflateEnd(&stream);
+
+        if(!complete)
+        {
+            throw npy_array_exception{npy_array_exception_type::generic};
+        }
+
+        return compressed;
+    }
+}
+
+npz_writer::npz_writer(const std::string& archive_path, npz_compression compression, int level, npy_thread_pool& pool, size_type chunk_size)
+    : _archive_stream{}, _compression{compression}, _level{level}, _pool(pool),
+      _chunk_size{std::min(std::max(chunk_size, size_type(1)), maximum_chunk_size)}, _entries{}, _names{}
+{
+    _archive_stream.open(archive_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+    if(!_archive_stream)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    _archive_stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+}
+
+npz_writer::~npz_writer()
+{
+    try
+    {
+        this->close();
+    }
+    catch(...) {}
+}
+
+bool npz_writer::is_open() const noexcept {return _archive_stream.is_open();}
+npz_writer::size_type npz_writer::size() const noexcept {return _entries.size();}
+
+void npz_writer::add_member(const std::string& name, const std::string& preamble, const char* payload, size_type payload_size)
+{
+    if(!_archive_stream.is_open())
+    {
+        throw npy_array_exception{npy_array_exception_type::generic};
+    }
+
+    if(!_names.insert(name).second)
+    {
+        throw std::invalid_argument{"The archive already has a member named " + name};
+    }
+
+    entry member_entry{};
+    member_entry.file_name = name + ".npy";
+    member_entry.uncompressed_size = preamble.size() + payload_size;
+
+    try
+    {
+        member_entry.local_header_offset = static_cast<uint64_t>(_archive_stream.tellp());
+
+        if(_compression == npz_compression::npz_deflated)
+        {
+            this->write_deflated(member_entry, preamble, payload, payload_size);
+        }
+        else
+        {
+            this->write_stored(member_entry, preamble, payload, payload_size);
+        }
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+
+    _entries.push_back(std::move(member_entry));
+}
+
+uint32_t npz_writer::parallel_crc32(const std::string& preamble, const char* payload, size_type payload_size)
+{
+    const size_type chunks = 1 + (payload_size + _chunk_size - 1) / _chunk_size;
+    std::vector<uLong> chunk_crcs(chunks);
+
+    _pool.parallel_for(0, chunks, [&](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            const char* data;
+            size_t size;
+            member_chunk(i, preamble, payload, payload_size, _chunk_size, data, size);
+            chunk_crcs[i] = crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+        }
+    });
+
+    uLong crc = chunk_crcs[0];
+
+    for(size_t i = 1; i < chunks; i++)
+    {
+        size_t chunk_size = std::min(_chunk_size, payload_size - (i - 1) * _chunk_size);
+        crc = crc32_combine(crc, chunk_crcs[i], static_cast<z_off_t>(chunk_size));
+    }
+
+    return static_cast<uint32_t>(crc);
+}
+
+void npz_writer::write_stored(entry& member_entry, const std::string& preamble, const char* payload, size_type payload_size)
+{
+    member_entry.method = stored_method;
+    member_entry.compressed_size = member_entry.uncompressed_size;
+    member_entry.crc32 = this->parallel_crc32(preamble, payload, payload_size);
+
+    std::string header = this->local_header(member_entry, member_entry.uncompressed_size >= zip32_limit);
+    _archive_stream.write(header.data(), header.size());
+    _archive_stream.write(preamble.data(), preamble.size());
+    _archive_stream.write(payload, payload_size);
+}
+
+void npz_writer::write_deflated(entry& member_entry, const std::string& preamble, const char* payload, size_type payload_size)
+{
+    member_entry.method = deflated_method;
+    member_entry.compressed_size = 0;
+
+    // The compressed size is known only at the end, so the local header is rewritten once the data is written.
+    // Deflate can expand incompressible data a little, hence the margin on the decision to use ZIP64.
+    const bool zip64 = member_entry.uncompressed_size + member_entry.uncompressed_size / 256 + (1 << 20) >= zip32_limit;
+    const std::streampos header_position = _archive_stream.tellp();
+
+    std::string header = this->local_header(member_entry, zip64);
+    _archive_stream.write(header.data(), header.size());
+
+    const size_type chunks = 1 + (payload_size + _chunk_size - 1) / _chunk_size;
+    // A batch of chunks is compressed in parallel and written before the next one, which bounds the memory used.
+    const size_type batch_size = 2 * _pool.size();
+    uLong crc = crc32(0, Z_NULL, 0);
+
+    std::vector<std::string> compressed_chunks{};
+    std::vector<uLong> chunk_crcs{};
+
+    for(size_type first = 0; first < chunks; first += batch_size)
+    {
+        const size_type last = std::min(first + batch_size, chunks);
+        compressed_chunks.assign(last - first, std::string{});
+        chunk_crcs.assign(last - first, 0);
+
+        _pool.parallel_for(first, last, [&](size_t begin, size_t end)
+        {
+            for(size_t i = begin; i < end; i++)
+            {
+                const char* data;
+                size_t size;
+                member_chunk(i, preamble, payload, payload_size, _chunk_size, data, size);
+                compressed_chunks[i - first] = deflate_chunk(data, size, _level, i == chunks - 1);
+                chunk_crcs[i - first] = crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+            }
+        });
+
+        for(size_type i = first; i < last; i++)
+        {
+            const char* data;
+            size_t size;
+            member_chunk(i, preamble, payload, payload_size, _chunk_size, data, size);
+
+            crc = crc32_combine(crc, chunk_crcs[i - first], static_cast<z_off_t>(size));
+            _archive_stream.write(compressed_chunks[i - first].data(), compressed_chunks[i - first].size());
+            member_entry.compressed_size += compressed_chunks[i - first].size();
+        }
+    }
+
+    member_entry.crc32 = static_cast<uint32_t>(crc);
+
+    if(!zip64 && member_entry.compressed_size >= zip32_limit)
+    {
+        throw npy_array_exception{npy_array_exception_type::generic};
+    }
+
+    const std::streampos end_position = _archive_stream.tellp();
+    header = this->local_header(member_entry, zip64);
+    _archive_stream.seekp(header_position);
+    _archive_stream.write(header.data(), header.size());
+    _archive_stream.seekp(end_position);
+}
+
+std::string npz_writer::local_header(const entry& member_entry, bool zip64) const
+{
+    std::string header{};
+
+    append_le32(header, local_header_signature);
+    append_le16(header, zip64 ? zip64_version : deflate_version);
+    append_le16(header, 0);
+    append_le16(header, member_entry.method);
+    append_le16(header, dos_time);
+    append_le16(header, dos_date);
+    append_le32(header, member_entry.crc32);
+    append_le32(header, zip64 ? static_cast<uint32_t>(zip32_limit) : static_cast<uint32_t>(member_entry.compressed_size));
+    append_le32(header, zip64 ? static_cast<uint32_t>(zip32_limit) : static_cast<uint32_t>(member_entry.uncompressed_size));
+    append_le16(header, static_cast<uint16_t>(member_entry.file_name.size()));
+    append_le16(header, zip64 ? 20 : 0);
+    header.append(member_entry.file_name);
+
+    // The local ZIP64 extra field has always both sizes.
+    if(zip64)
+    {
+        append_le16(header, zip64_extra_field_id);
+        append_le16(header, 16);
+        append_le64(header, member_entry.uncompressed_size);
+        append_le64(header, member_entry.compressed_size);
+    }
+
+    return header;
+}
+
+void npz_writer::write_central_directory()
+{
+    const uint64_t directory_offset = static_cast<uint64_t>(_archive_stream.tellp());
+    std::string directory{};
+
+    for(const auto& member_entry : _entries)
+    {
+        // The central ZIP64 extra field has only the saturated fields, in this order.
+        std::string extra{};
+        if(member_entry.uncompressed_size >= zip32_limit) append_le64(extra, member_entry.uncompressed_size);
+        if(member_entry.compressed_size >= zip32_limit) append_le64(extra, member_entry.compressed_size);
+        if(member_entry.local_header_offset >= zip32_limit) append_le64(extra, member_entry.local_header_offset);
+
+        if(!extra.empty())
+        {
+            std::string field{};
+            append_le16(field, zip64_extra_field_id);
+            append_le16(field, static_cast<uint16_t>(extra.size()));
+            extra.insert(0, field);
+        }
+
+        const uint16_t version = extra.empty() ? deflate_version : zip64_version;
+
+        append_le32(directory, central_header_signature);
+        append_le16(directory, unix_host | version);
+        append_le16(directory, version);
+        append_le16(directory, 0);
+        append_le16(directory, member_entry.method);
+        append_le16(directory, dos_time);
+        append_le16(directory, dos_date);
+        append_le32(directory, member_entry.crc32);
+        append_le32(directory, saturate(member_entry.compressed_size));
+        append_le32(directory, saturate(member_entry.uncompressed_size));
+        append_le16(directory, static_cast<uint16_t>(member_entry.file_name.size()));
+        append_le16(directory, static_cast<uint16_t>(extra.size()));
+        append_le16(directory, 0);
+        append_le16(directory, 0);
+        append_le16(directory, 0);
+        append_le32(directory, external_attributes);
+        append_le32(directory, saturate(member_entry.local_header_offset));
+        directory.append(member_entry.file_name);
+        directory.append(extra);
+    }
+
+    const uint64_t directory_size = directory.size();
+    const uint64_t entries = _entries.size();
+
+    if(entries >= zip32_count_limit || directory_offset >= zip32_limit || directory_size >= zip32_limit)
+    {
+        const uint64_t zip64_end_offset = directory_offset + directory_size;
+
+        append_le32(directory, zip64_end_of_central_directory_signature);
+        // The size of the record following this field.
+        append_le64(directory, 44);
+        append_le16(directory, zip64_version);
+        append_le16(directory, zip64_version);
+        append_le32(directory, 0);
+        append_le32(directory, 0);
+        append_le64(directory, entries);
+        append_le64(directory, entries);
+        append_le64(directory, directory_size);
+        append_le64(directory, directory_offset);
+
+        append_le32(directory, zip64_locator_signature);
+        append_le32(directory, 0);
+        append_le64(directory, zip64_end_offset);
+        append_le32(directory, 1);
+    }
+
+    append_le32(directory, end_of_central_directory_signature);
+    append_le16(directory, 0);
+    append_le16(directory, 0);
+    append_le16(directory, static_cast<uint16_t>(std::min<uint64_t>(entries, zip32_count_limit)));
+    append_le16(directory, static_cast<uint16_t>(std::min<uint64_t>(entries, zip32_count_limit)));
+    append_le32(directory, saturate(directory_size));
+    append_le32(directory, saturate(directory_offset));
+    append_le16(directory, 0);
+
+    _archive_stream.write(directory.data(), directory.size());
+}
+
+void npz_writer::close()
+{
+    if(!_archive_stream.is_open()) return;
+
+    try
+    {
+        this->write_central_directory();
+        _archive_stream.close();
+    }
+    catch(const std::ios_base::failure& failure_exception)
+    {
+        // The archive is unusable, it is closed anyway so that the destructor does not try again.
+        _archive_stream.exceptions(std::ios_base::goodbit);
+        _archive_stream.close();
+
+        throw npy_array_exception{npy_array_exception_type::input_output_error};
+    }
+}
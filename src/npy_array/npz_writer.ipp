@@ -0,0 +1,9 @@
+#include "npy_array/npz_writer.h"
+
+template<typename T>
+void npz_writer::add(const std::string& name, const npy_array<T>& array)
+{
+    std::string preamble = npy_header{array.dtype(), array.fortran_order(), array.shape()}.str();
+
+    this->add_member(name, preamble, reinterpret_cast<const char*>(array.data()), array.byte_size());
+}
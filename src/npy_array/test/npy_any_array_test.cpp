@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "npy_array/npy_any_array.h"
+
+TEST(NPYAnyArrayTest, ConstructorTest)
+{
+    const std::vector<std::pair<std::string, npy_dtype>> type_files{{
+        {"bool", npy_dtype::bool_8()},
+        {"int8", npy_dtype::int_8()},
+        {"int16", npy_dtype::int_16()},
+        {"int32", npy_dtype::int_32()},
+        {"int64", npy_dtype::int_64()},
+        {"uint8", npy_dtype::uint_8()},
+        {"uint16", npy_dtype::uint_16()},
+        {"uint32", npy_dtype::uint_32()},
+        {"uint64", npy_dtype::uint_64()},
+        {"float32", npy_dtype::float_32()},
+        {"float64", npy_dtype::float_64()},
+        {"float128", npy_dtype::float_128()},
+        {"complex64", npy_dtype::complex_64()},
+        {"complex128", npy_dtype::complex_128()},
+        {"complex256", npy_dtype::complex_256()}
+    }};
+
+    for(const auto& type_file : type_files)
+    {
+        npy_any_array array{"./test_resources/types/" + type_file.first + ".npy"};
+
+        EXPECT_EQ(array.dtype(), type_file.second);
+        EXPECT_EQ(array.shape(), std::vector<size_t>{10});
+        EXPECT_EQ(array.size(), 10);
+        EXPECT_EQ(array.byte_size(), 10 * type_file.second.item_size());
+
+        // The visitor receives the array of the matching C++ type.
+        npy_dtype visited_dtype = array.visit([](auto& typed_array)
+        {
+            return npy_dtype::from_type<typename std::decay_t<decltype(typed_array)>::value_type>();
+        });
+
+        EXPECT_EQ(visited_dtype, type_file.second);
+    }
+
+    try
+    {
+        npy_any_array{"./test_resources/types/float16.npy"};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_dtype);
+    }
+
+    try
+    {
+        npy_any_array{"./test_resources/missing.npy"};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+}
+
+TEST(NPYAnyArrayTest, CastTest)
+{
+    npy_any_array array{"./test_resources/10.npy", npy_array_mode::map_read_only};
+
+    EXPECT_TRUE(array.is<long>());
+    EXPECT_FALSE(array.is<int>());
+    EXPECT_TRUE(array.mapped());
+
+    const npy_array<long>& typed_array = array.as<long>();
+    EXPECT_EQ(typed_array.data(), array.data());
+    EXPECT_EQ(typed_array.at(3), 3);
+
+    try
+    {
+        array.as<double>();
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_dtype);
+    }
+
+    // A copy owns its payload.
+    npy_any_array copy{array};
+    EXPECT_FALSE(copy.mapped());
+    EXPECT_NE(copy.data(), array.data());
+    EXPECT_TRUE(std::equal(copy.as<long>().cbegin(), copy.as<long>().cend(), typed_array.cbegin()));
+
+    npy_any_array wrapped{npy_array<float>{{2, 2}, {1.0f, 2.0f, 3.0f, 4.0f}}};
+    EXPECT_EQ(wrapped.dtype(), npy_dtype::float_32());
+
+    size_t byte_size = wrapped.visit([](const auto& typed_array)
+    {
+        return typed_array.byte_size();
+    });
+
+    EXPECT_EQ(byte_size, 4 * sizeof(float));
+
+    wrapped.save("./test_resources/any.npy", npy_endianness::big_endian);
+
+    npy_any_array reloaded{"./test_resources/any.npy"};
+    EXPECT_EQ(reloaded.dtype(), npy_dtype::float_32());
+    EXPECT_FLOAT_EQ(reloaded.as<float>().at({1, 1}), 4.0f);
+
+    std::remove("./test_resources/any.npy");
+}
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
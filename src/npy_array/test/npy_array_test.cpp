@@ -2,6 +2,11 @@
 
 #include "npy_array/npy_array.h"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <bitset>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 
@@ -63,6 +68,7 @@ TEST(NPYArrayTest, ConstructorMagicStringTest)
 
 TEST(NPYArrayTest, ConstructorMajorVersion)
 {
+    // A valid version 2.0 file whose structured dtype is not supported.
     try
     {
         npy_array<float>{"./test_resources/version_2.npy"};
@@ -70,9 +76,10 @@ TEST(NPYArrayTest, ConstructorMajorVersion)
     }
     catch(const npy_array_exception& e)
     {
-        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_version);
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
     }
 
+    // A version 3.0 file having a version 1.0 header length, that is a header length larger than the file.
     try
     {
         npy_array<float>{"./test_resources/version_3.npy"};
@@ -80,7 +87,7 @@ TEST(NPYArrayTest, ConstructorMajorVersion)
     }
     catch(const npy_array_exception& e)
     {
-        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_version);
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
     }
 
     try
@@ -572,6 +579,1075 @@ TEST(NPYArrayTest, ListInitOperator)
     EXPECT_FLOAT_EQ(x, 1.0f);
 }
 
+TEST(NPYArrayTest, MapReadOnlyTest)
+{
+    npy_array<float> loaded{"./test_resources/archive.npy"};
+    npy_array<float> mapped{"./test_resources/archive.npy", npy_array_mode::map_read_only};
+    std::vector<size_t> s{{1, 256, 13, 13}};
+
+    EXPECT_FALSE(loaded.mapped());
+    EXPECT_TRUE(mapped.mapped());
+    EXPECT_EQ(mapped.shape(), s);
+    EXPECT_EQ(mapped.dtype(), npy_dtype::float_32());
+    EXPECT_EQ(mapped.size(), loaded.size());
+    EXPECT_EQ(mapped.byte_size(), loaded.byte_size());
+    EXPECT_TRUE(std::equal(mapped.cbegin(), mapped.cend(), loaded.cbegin()));
+    EXPECT_FLOAT_EQ(mapped.at({0, 1, 1, 1}), loaded.at({0, 1, 1, 1}));
+
+    npy_array<long> range{"./test_resources/10.npy", npy_array_mode::map_read_only};
+
+    for(size_t i = 0; i != range.size(); i++)
+    {
+        EXPECT_EQ(range[i], i);
+        EXPECT_EQ(range.at(i), i);
+    }
+
+    EXPECT_THROW(range.at(range.size()), std::out_of_range);
+
+    // A copy of a mapped array owns its payload, a move keeps the mapping.
+    npy_array<long> copy{range};
+    EXPECT_FALSE(copy.mapped());
+    EXPECT_NE(copy.data(), range.data());
+    EXPECT_TRUE(std::equal(copy.cbegin(), copy.cend(), range.cbegin()));
+
+    const long* mapped_data = range.data();
+    npy_array<long> moved{std::move(range)};
+    EXPECT_TRUE(moved.mapped());
+    EXPECT_EQ(moved.data(), mapped_data);
+    EXPECT_EQ(range.size(), 0);
+    EXPECT_FALSE(range.mapped());
+
+    try
+    {
+        npy_array<float>{"./test_resources/invalid_magic_string.npy", npy_array_mode::map_read_only};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::invalid_magic_string);
+    }
+
+    try
+    {
+        npy_array<float>{"./test_resources/fake_shape_2.npy", npy_array_mode::map_read_only};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+    }
+}
+
+TEST(NPYArrayTest, MapReadWriteTest)
+{
+    npy_array<long> range{"./test_resources/10.npy"};
+    range.save("./test_resources/mapped.npy");
+
+    {
+        npy_array<long> mapped{"./test_resources/mapped.npy", npy_array_mode::map_read_write};
+        EXPECT_TRUE(mapped.mapped());
+
+        for(size_t i = 0; i != mapped.size(); i++)
+        {
+            mapped[i] = i * 2;
+        }
+
+        mapped.sync();
+    }
+
+    npy_array<long> reloaded{"./test_resources/mapped.npy"};
+    EXPECT_EQ(reloaded.shape(), range.shape());
+
+    for(size_t i = 0; i != reloaded.size(); i++)
+    {
+        EXPECT_EQ(reloaded[i], i * 2);
+    }
+
+    std::remove("./test_resources/mapped.npy");
+}
+
+TEST(NPYArrayTest, CreateMappedTest)
+{
+    {
+        npy_array<float> created = npy_array<float>::create_mapped("./test_resources/mapped.npy", {3, 4});
+        EXPECT_TRUE(created.mapped());
+        EXPECT_EQ(created.size(), 12);
+        EXPECT_EQ(created.dtype(), npy_dtype::float_32());
+        EXPECT_TRUE(std::all_of(created.cbegin(), created.cend(), [](float f){return f == 0.0f;}));
+
+        created[{2, 3}] = 5.0f;
+        created.sync(true);
+    }
+
+    npy_array<float> reloaded{"./test_resources/mapped.npy"};
+    std::vector<size_t> s{{3, 4}};
+    EXPECT_EQ(reloaded.shape(), s);
+    EXPECT_FLOAT_EQ(reloaded.at({2, 3}), 5.0f);
+    EXPECT_FLOAT_EQ(reloaded.at({0, 0}), 0.0f);
+
+    std::remove("./test_resources/mapped.npy");
+
+    // The file is created with the permissions left by the umask, like the saved ones.
+    const mode_t mask = ::umask(0002);
+    npy_array<float>::create_mapped("./test_resources/mapped.npy", {3, 4});
+    ::umask(mask);
+
+    struct stat status;
+    ASSERT_EQ(::stat("./test_resources/mapped.npy", &status), 0);
+    EXPECT_EQ(status.st_mode & 07777, 0664);
+
+    std::remove("./test_resources/mapped.npy");
+
+    EXPECT_THROW(npy_array<float>::create_mapped("/test/ereregfdgdfgdgdfgfdgfgdgfdfggdf.npy", {3, 4}), npy_array_exception);
+}
+
+TEST(NPYArrayTest, SaveVersionTest)
+{
+    npy_array<long> range{"./test_resources/10.npy"};
+    range.save("./test_resources/version.npy");
+
+    std::ifstream version_file{"./test_resources/version.npy", std::ios_base::binary};
+    std::string preamble(10, '\0');
+    version_file.read(&preamble[0], preamble.size());
+    version_file.close();
+
+    EXPECT_EQ(preamble[6], '\x01');
+    EXPECT_EQ((static_cast<uint8_t>(preamble[8]) + 10) % 64, 0);
+
+    // A header longer than 65535 bytes requires the 4 bytes header length of version 2.0.
+    std::vector<size_t> shape(25000, 1);
+    shape[0] = 3;
+    npy_array<int> long_header{shape, std::vector<int>{{1, 2, 3}}};
+    long_header.save("./test_resources/version.npy");
+
+    version_file.open("./test_resources/version.npy", std::ios_base::binary);
+    version_file.read(&preamble[0], preamble.size());
+    version_file.close();
+
+    EXPECT_EQ(preamble[6], '\x02');
+
+    npy_array<int> reloaded{"./test_resources/version.npy"};
+    EXPECT_EQ(reloaded.shape(), shape);
+    EXPECT_EQ(reloaded.at(2), 3);
+
+    npy_array<int> mapped{"./test_resources/version.npy", npy_array_mode::map_read_only};
+    EXPECT_TRUE(std::equal(mapped.cbegin(), mapped.cend(), reloaded.cbegin()));
+
+    std::remove("./test_resources/version.npy");
+}
+
+TEST(NPYArrayTest, SaveByteOrderTest)
+{
+    npy_array<long> range{"./test_resources/10.npy"};
+    range.save("./test_resources/big_endian.npy", npy_endianness::big_endian);
+
+    std::ifstream big_endian_file{"./test_resources/big_endian.npy", std::ios_base::binary};
+    npy_header header = npy_header::read(big_endian_file);
+    int64_t first_values[2];
+    big_endian_file.read(reinterpret_cast<char*>(first_values), sizeof(first_values));
+    big_endian_file.close();
+
+    EXPECT_EQ(header.dtype().str(), ">i8");
+    EXPECT_EQ(first_values[1], static_cast<int64_t>(__builtin_bswap64(1)));
+
+    npy_array<long> reloaded{"./test_resources/big_endian.npy"};
+    EXPECT_EQ(reloaded.dtype(), npy_dtype::int_64());
+    EXPECT_TRUE(std::equal(reloaded.cbegin(), reloaded.cend(), range.cbegin()));
+
+    try
+    {
+        npy_array<long>{"./test_resources/big_endian.npy", npy_array_mode::map_read_only};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_dtype);
+    }
+
+    try
+    {
+        npy_array<unsigned long>{"./test_resources/big_endian.npy"};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+    }
+
+    npy_array<std::complex<double>> complex{"./test_resources/types/complex128.npy"};
+    for(size_t i = 0; i != complex.size(); i++)
+    {
+        complex[i] = std::complex<double>{0.5 + i, -1.0 * i};
+    }
+    complex.save("./test_resources/big_endian.npy", npy_endianness::big_endian);
+
+    npy_array<std::complex<double>> complex_reloaded{"./test_resources/big_endian.npy"};
+    EXPECT_TRUE(std::equal(complex_reloaded.cbegin(), complex_reloaded.cend(), complex.cbegin()));
+
+    // Saving with the native byte order is the default.
+    complex.save("./test_resources/big_endian.npy", npy_endianness::native);
+    big_endian_file.open("./test_resources/big_endian.npy", std::ios_base::binary);
+    EXPECT_EQ(npy_header::read(big_endian_file).dtype(), npy_dtype::complex_128());
+    big_endian_file.close();
+
+    std::remove("./test_resources/big_endian.npy");
+}
+
+TEST(NPYArrayTest, FortranOrderTest)
+{
+    // Write by hand a Fortran-ordered payload where the element (i, j, k) has value 10000 * i + 100 * j + k.
+    const std::vector<size_t> shape{{67, 5, 41}};
+    std::vector<int> fortran_payload{};
+
+    for(size_t k = 0; k < shape[2]; k++)
+        for(size_t j = 0; j < shape[1]; j++)
+            for(size_t i = 0; i < shape[0]; i++)
+                fortran_payload.push_back(static_cast<int>(10000 * i + 100 * j + k));
+
+    std::string preamble = npy_header{npy_dtype::int_32(), true, shape}.str();
+    std::ofstream fortran_file{"./test_resources/fortran.npy", std::ios_base::binary};
+    fortran_file.write(preamble.data(), preamble.size());
+    fortran_file.write(reinterpret_cast<const char*>(fortran_payload.data()), fortran_payload.size() * sizeof(int));
+    fortran_file.close();
+
+    npy_array<int> fortran{"./test_resources/fortran.npy"};
+    npy_array<int> mapped{"./test_resources/fortran.npy", npy_array_mode::map_read_only};
+    npy_array<int> c_order{"./test_resources/fortran.npy", npy_array_mode::load_c_order};
+
+    EXPECT_TRUE(fortran.fortran_order());
+    EXPECT_TRUE(mapped.fortran_order());
+    EXPECT_FALSE(c_order.fortran_order());
+    EXPECT_TRUE(std::equal(fortran.cbegin(), fortran.cend(), fortran_payload.cbegin()));
+
+    for(size_t i = 0; i < shape[0]; i++)
+    {
+        for(size_t j = 0; j < shape[1]; j++)
+        {
+            for(size_t k = 0; k < shape[2]; k++)
+            {
+                int expected = static_cast<int>(10000 * i + 100 * j + k);
+                EXPECT_EQ(fortran.at({i, j, k}), expected);
+                EXPECT_EQ((mapped[{i, j, k}]), expected);
+                EXPECT_EQ((c_order[{i, j, k}]), expected);
+                EXPECT_EQ(c_order[(i * shape[1] + j) * shape[2] + k], expected);
+            }
+        }
+    }
+
+    // The transpose runs on the pool given to the constructor.
+    npy_thread_pool pool{2};
+    npy_array<int> pooled{"./test_resources/fortran.npy", npy_array_mode::load_c_order, pool};
+    EXPECT_FALSE(pooled.fortran_order());
+    EXPECT_TRUE(std::equal(pooled.cbegin(), pooled.cend(), c_order.cbegin()));
+
+    mapped.to_c_order();
+    EXPECT_FALSE(mapped.mapped());
+    EXPECT_FALSE(mapped.fortran_order());
+    EXPECT_TRUE(std::equal(mapped.cbegin(), mapped.cend(), c_order.cbegin()));
+
+    // Saving keeps the order of the payload.
+    fortran.save("./test_resources/fortran.npy");
+    npy_array<int> reloaded{"./test_resources/fortran.npy"};
+    EXPECT_TRUE(reloaded.fortran_order());
+    EXPECT_EQ(reloaded.at({66, 4, 40}), 660440);
+
+    // A 2-d matrix, transposed on a pool of a single thread as well as on several threads.
+    npy_thread_pool single_thread{1};
+    npy_array<double> matrix{{300, 200}};
+    std::iota(matrix.begin(), matrix.end(), 0.0);
+    std::vector<double> transposed(matrix.size());
+    npy_fortran_to_c_order(matrix.data(), transposed.data(), matrix.shape(), single_thread);
+
+    for(size_t row = 0; row < 300; row++)
+    {
+        for(size_t column = 0; column < 200; column++)
+        {
+            ASSERT_EQ(transposed[row * 200 + column], static_cast<double>(column * 300 + row));
+        }
+    }
+
+    std::vector<double> parallel_transposed(matrix.size());
+    npy_fortran_to_c_order(matrix.data(), parallel_transposed.data(), matrix.shape(), npy_thread_pool::shared());
+    EXPECT_EQ(parallel_transposed, transposed);
+
+    std::remove("./test_resources/fortran.npy");
+}
+
+TEST(NPYArrayTest, ConversionKernelTest)
+{
+    // Half precision bits of 1, -2.5, 65504 (the largest half), 2^-24 (the smallest subnormal), infinity, and -0.
+    const std::vector<uint16_t> half_values{0x3C00, 0xC100, 0x7BFF, 0x0001, 0x7C00, 0x8000};
+    const std::vector<float> float_values{1.0f, -2.5f, 65504.0f, 5.9604644775390625e-8f, std::numeric_limits<float>::infinity(), -0.0f};
+
+    // Repeat the values so that both the vectorized loop and the scalar tail are used.
+    std::vector<uint16_t> halves{};
+    std::vector<float> expected_floats{};
+
+    for(size_t i = 0; i < 7; i++)
+    {
+        halves.insert(halves.end(), half_values.cbegin(), half_values.cend());
+        expected_floats.insert(expected_floats.end(), float_values.cbegin(), float_values.cend());
+    }
+
+    std::vector<float> floats(halves.size());
+    npy_half_to_float(halves.data(), floats.data(), halves.size());
+    EXPECT_EQ(floats, expected_floats);
+    EXPECT_TRUE(std::signbit(floats[5]));
+
+    std::vector<double> doubles{{1.5, -1e300, 1e300, std::numeric_limits<double>::infinity(), 0.1, -3.0, 1e-300, 2.0, 7.0}};
+    std::vector<float> narrowed(doubles.size());
+
+    npy_double_to_float(doubles.data(), narrowed.data(), doubles.size(), true);
+    EXPECT_EQ(narrowed[0], 1.5f);
+    EXPECT_EQ(narrowed[1], std::numeric_limits<float>::lowest());
+    EXPECT_EQ(narrowed[2], std::numeric_limits<float>::max());
+    EXPECT_EQ(narrowed[3], std::numeric_limits<float>::infinity());
+    EXPECT_EQ(narrowed[4], 0.1f);
+    EXPECT_EQ(narrowed[8], 7.0f);
+
+    npy_double_to_float(doubles.data(), narrowed.data(), doubles.size(), false);
+    EXPECT_EQ(narrowed[1], -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(narrowed[2], std::numeric_limits<float>::infinity());
+
+    const std::vector<int64_t> integers{{-1000, -1, 0, 127, 300}};
+    std::vector<int8_t> saturated(integers.size());
+    npy_convert(integers.data(), npy_dtype::int_64(), saturated.data(), integers.size(), npy_cast::cast_saturate);
+    EXPECT_EQ(saturated, (std::vector<int8_t>{{-128, -1, 0, 127, 127}}));
+
+    std::vector<uint8_t> unsigned_saturated(integers.size());
+    npy_convert(integers.data(), npy_dtype::int_64(), unsigned_saturated.data(), integers.size(), npy_cast::cast_saturate);
+    EXPECT_EQ(unsigned_saturated, (std::vector<uint8_t>{{0, 0, 0, 127, 255}}));
+
+    std::vector<uint8_t> wrapped(integers.size());
+    npy_convert(integers.data(), npy_dtype::int_64(), wrapped.data(), integers.size(), npy_cast::cast_unchecked);
+    EXPECT_EQ(wrapped, (std::vector<uint8_t>{{24, 255, 0, 127, 44}}));
+
+    const std::vector<float> reals{{std::nan(""), -1e10f, 2.7f, 1e10f}};
+    std::vector<int32_t> truncated(reals.size());
+    npy_convert(reals.data(), npy_dtype::float_32(), truncated.data(), reals.size(), npy_cast::cast_saturate);
+    EXPECT_EQ(truncated, (std::vector<int32_t>{{0, std::numeric_limits<int32_t>::min(), 2, std::numeric_limits<int32_t>::max()}}));
+
+    std::vector<std::complex<double>> complexes(integers.size());
+    npy_convert(integers.data(), npy_dtype::int_64(), complexes.data(), integers.size(), npy_cast::cast_unchecked);
+    EXPECT_EQ(complexes[4], std::complex<double>(300.0, 0.0));
+
+    EXPECT_FALSE(npy_convertible<double>(npy_dtype::complex_64()));
+    EXPECT_TRUE(npy_convertible<std::complex<float>>(npy_dtype::complex_128()));
+    EXPECT_TRUE(npy_convertible<int>(npy_dtype::float_16()));
+    EXPECT_FALSE(npy_convertible<int>(npy_dtype::null()));
+}
+
+TEST(NPYArrayTest, ConvertedLoadTest)
+{
+    // A big endian half precision file, written by hand since half has no C++ type.
+    const std::vector<uint16_t> halves{0x3C00, 0xC100, 0x7BFF, 0x3555, 0x0000, 0x4900};
+    std::string preamble = npy_header{npy_dtype::float_16().with_byte_order(npy_endianness::big_endian), false, {2, 3}}.str();
+    std::ofstream half_file{"./test_resources/half.npy", std::ios_base::binary};
+    half_file.write(preamble.data(), preamble.size());
+
+    for(uint16_t half : halves)
+    {
+        uint16_t big_endian_half = __builtin_bswap16(half);
+        half_file.write(reinterpret_cast<const char*>(&big_endian_half), sizeof(big_endian_half));
+    }
+
+    half_file.close();
+
+    npy_array<float> half_floats = npy_array<float>::load_converted("./test_resources/half.npy");
+    EXPECT_EQ(half_floats.shape(), (std::vector<size_t>{2, 3}));
+    EXPECT_EQ(half_floats.dtype(), npy_dtype::float_32());
+    EXPECT_EQ(half_floats.at({0, 0}), 1.0f);
+    EXPECT_EQ(half_floats.at({0, 1}), -2.5f);
+    EXPECT_EQ(half_floats.at({0, 2}), 65504.0f);
+    EXPECT_NEAR(half_floats.at({1, 0}), 1.0f / 3.0f, 1e-3f);
+    EXPECT_EQ(half_floats.at({1, 2}), 10.0f);
+
+    npy_array<short> half_shorts = npy_array<short>::load_converted("./test_resources/half.npy", npy_cast::cast_saturate);
+    EXPECT_EQ(half_shorts.at({0, 1}), -2);
+    EXPECT_EQ(half_shorts.at({0, 2}), std::numeric_limits<short>::max());
+
+    // Without conversion a half precision file cannot be loaded.
+    try
+    {
+        npy_array<float>{"./test_resources/half.npy"};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+    }
+
+    std::remove("./test_resources/half.npy");
+
+    npy_array<double> range{{3000}};
+    std::iota(range.begin(), range.end(), -1000.25);
+    range.save("./test_resources/range.npy");
+
+    npy_array<float> range_floats = npy_array<float>::load_converted("./test_resources/range.npy");
+    npy_array<long> range_longs = npy_array<long>::load_converted("./test_resources/range.npy");
+    npy_array<double> range_doubles = npy_array<double>::load_converted("./test_resources/range.npy");
+
+    for(size_t i = 0; i < range.size(); i++)
+    {
+        ASSERT_EQ(range_floats[i], static_cast<float>(range[i]));
+        ASSERT_EQ(range_longs[i], static_cast<long>(range[i]));
+    }
+
+    EXPECT_TRUE(std::equal(range_doubles.cbegin(), range_doubles.cend(), range.cbegin()));
+
+    std::remove("./test_resources/range.npy");
+
+    try
+    {
+        npy_array<float>::load_converted("./test_resources/types/complex64.npy");
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_dtype);
+    }
+
+    npy_array<std::complex<double>> complexes = npy_array<std::complex<double>>::load_converted("./test_resources/types/complex64.npy");
+    EXPECT_EQ(complexes.size(), 10);
+}
+
+TEST(NPYArrayTest, AsyncTest)
+{
+    std::future<npy_array<long>> loading = npy_array<long>::async_load("./test_resources/10.npy");
+    std::future<npy_array<long>> missing = npy_array<long>::async_load("./test_resources/missing.npy");
+    std::future<npy_array<int>> mismatched = npy_array<int>::async_load("./test_resources/types/float32.npy", npy_array_mode::load_c_order);
+
+    npy_array<long> range = loading.get();
+    EXPECT_EQ(range.at(9), 9);
+
+    try
+    {
+        missing.get();
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+
+    try
+    {
+        mismatched.get();
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+    }
+
+    // Several saves in flight at once, each one reloaded asynchronously once written.
+    std::vector<std::future<void>> saving{};
+    for(size_t i = 0; i < 4; i++)
+    {
+        saving.push_back(range.async_save("./test_resources/async_" + std::to_string(i) + ".npy", i % 2 == 0 ? npy_endianness::little_endian : npy_endianness::big_endian));
+    }
+
+    for(size_t i = 0; i < saving.size(); i++)
+    {
+        saving[i].get();
+
+        npy_array<long> reloaded = npy_array<long>::async_load("./test_resources/async_" + std::to_string(i) + ".npy").get();
+        EXPECT_TRUE(std::equal(reloaded.cbegin(), reloaded.cend(), range.cbegin()));
+
+        std::remove(("./test_resources/async_" + std::to_string(i) + ".npy").c_str());
+    }
+}
+
+TEST(NPYArrayTest, DirectIOTest)
+{
+    npy_array<double> matrix{{300, 1001}};
+    for(size_t i = 0; i < matrix.size(); i++)
+    {
+        matrix[i] = static_cast<double>(i) * 0.5;
+    }
+
+    for(npy_endianness byte_order : {npy_endianness::native, npy_endianness::big_endian})
+    {
+        npy_save_options options{};
+        options.byte_order = byte_order;
+        options.direct = true;
+        matrix.save("./test_resources/direct.npy", options);
+
+        // The padding of the last chunk is truncated away.
+        std::ifstream direct_file{"./test_resources/direct.npy", std::ios_base::binary | std::ios_base::ate};
+        EXPECT_EQ(static_cast<size_t>(direct_file.tellg()), 128 + matrix.byte_size());
+        direct_file.close();
+
+        npy_array<double> loaded{"./test_resources/direct.npy", npy_array_mode::load_direct};
+        EXPECT_FALSE(loaded.mapped());
+        EXPECT_EQ(loaded.shape(), matrix.shape());
+        EXPECT_TRUE(std::equal(loaded.cbegin(), loaded.cend(), matrix.cbegin()));
+
+        // The payload is placed like in the file, so that it is read in place, and its copies are placed as usual.
+        EXPECT_EQ((reinterpret_cast<uintptr_t>(loaded.data()) - 128) % npy_direct_alignment, 0);
+        npy_array<double> copied{loaded};
+        EXPECT_TRUE(std::equal(copied.cbegin(), copied.cend(), matrix.cbegin()));
+
+        // And the loaded payload is written back in place.
+        options.byte_order = npy_endianness::native;
+        loaded.save("./test_resources/direct_copy.npy", options);
+        EXPECT_TRUE(std::equal(matrix.cbegin(), matrix.cend(), npy_array<double>{"./test_resources/direct_copy.npy"}.cbegin()));
+        std::remove("./test_resources/direct_copy.npy");
+    }
+
+    // Unaligned ranges split in many small chunks.
+    std::string content(3 * npy_direct_alignment + 123, '\0');
+    for(size_t i = 0; i < content.size(); i++)
+    {
+        content[i] = static_cast<char>(i * 7);
+    }
+
+    npy_direct_write("./test_resources/direct.npy", content.size(), [&](uint64_t offset, char* buffer, size_t length)
+    {
+        std::copy(content.cbegin() + offset, content.cbegin() + offset + length, buffer);
+    }, npy_thread_pool::shared(), 1);
+
+    std::string read(content.size() - 5000, '\0');
+    npy_direct_read("./test_resources/direct.npy", 4999, &read[0], read.size(), npy_thread_pool::shared(), 1);
+    EXPECT_EQ(read, content.substr(4999, read.size()));
+
+    // Destinations placed like the file are read in place, except for the partial pages at the ends of the range.
+    std::vector<char, npy_aligned_allocator<char, npy_direct_alignment>> placed(content.size() + npy_direct_alignment);
+
+    for(std::pair<size_t, size_t> range : {std::make_pair(size_t(4999), read.size()), std::make_pair(size_t(4096), size_t(8192)), std::make_pair(size_t(10), size_t(20))})
+    {
+        std::fill(placed.begin(), placed.end(), '\0');
+        char* destination = placed.data() + range.first % npy_direct_alignment;
+
+        npy_direct_read("./test_resources/direct.npy", range.first, destination, range.second, npy_thread_pool::shared(), 1);
+        EXPECT_EQ(std::string(destination, range.second), content.substr(range.first, range.second));
+
+        // The bytes around the range are left untouched.
+        auto zero = [](char byte) {return byte == '\0';};
+        EXPECT_TRUE(std::all_of(placed.data(), destination, zero));
+        EXPECT_TRUE(std::all_of(destination + range.second, placed.data() + placed.size(), zero));
+    }
+
+    // Sources placed like the file are written in place, fill produces only the partial pages.
+    std::copy(content.cbegin() + 100, content.cend(), placed.begin() + 100);
+    std::atomic<size_t> filled{0};
+
+    npy_direct_write("./test_resources/direct.npy", content.size(), [&](uint64_t offset, char* buffer, size_t length)
+    {
+        std::copy(content.cbegin() + offset, content.cbegin() + offset + length, buffer);
+        filled += length;
+    }, npy_thread_pool::shared(), 1, placed.data() + 100, 100);
+
+    EXPECT_LT(filled, content.size());
+    std::fill(read.begin(), read.end(), '\0');
+    npy_direct_read("./test_resources/direct.npy", 4999, &read[0], read.size(), npy_thread_pool::shared(), 1);
+    EXPECT_EQ(read, content.substr(4999, read.size()));
+
+    try
+    {
+        npy_direct_read("./test_resources/direct.npy", 4999, &read[0], read.size() + 2, npy_thread_pool::shared());
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+
+    std::remove("./test_resources/direct.npy");
+}
+
+// Stateful allocator counting the bytes it allocates in a counter shared by its copies.
+template<typename T>
+struct counting_allocator
+{
+    typedef T value_type;
+
+    std::shared_ptr<size_t> allocated;
+
+    counting_allocator() : allocated{std::make_shared<size_t>(0)} {}
+    template<typename U>
+    counting_allocator(const counting_allocator<U>& other) noexcept : allocated{other.allocated} {}
+
+    T* allocate(size_t count)
+    {
+        *allocated += count * sizeof(T);
+        return std::allocator<T>{}.allocate(count);
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {std::allocator<T>{}.deallocate(pointer, count);}
+
+    template<typename U>
+    bool operator==(const counting_allocator<U>& other) const noexcept {return allocated == other.allocated;}
+    template<typename U>
+    bool operator!=(const counting_allocator<U>& other) const noexcept {return allocated != other.allocated;}
+};
+
+TEST(NPYArrayTest, AllocatorTest)
+{
+    npy_array<float, npy_aligned_allocator<float>> aligned{{3, 5}};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned.data()) % 64, 0);
+
+    for(size_t i = 0; i < aligned.size(); i++)
+    {
+        aligned[i] = static_cast<float>(i);
+    }
+
+    aligned.save("./test_resources/allocator.npy");
+
+    npy_array<float, npy_aligned_allocator<float>> loaded{"./test_resources/allocator.npy"};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(loaded.data()) % 64, 0);
+    EXPECT_TRUE(std::equal(loaded.cbegin(), loaded.cend(), aligned.cbegin()));
+
+    npy_array<float, npy_aligned_allocator<float>> copied{loaded};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(copied.data()) % 64, 0);
+    EXPECT_TRUE(std::equal(copied.cbegin(), copied.cend(), aligned.cbegin()));
+
+    // The payload of a boolean array is stored with a rebound allocator.
+    npy_array<bool, npy_aligned_allocator<bool>> flags{{100}};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(flags.data()) % 64, 0);
+
+    npy_array<double, npy_huge_page_allocator<double>> huge{{1024, 1024}};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(huge.data()) % npy_huge_page_size, 0);
+
+    for(size_t i = 0; i < huge.size(); i++)
+    {
+        huge[i] = static_cast<double>(i);
+    }
+
+    huge.save("./test_resources/allocator.npy");
+
+    npy_array<double, npy_huge_page_allocator<double>> huge_loaded{"./test_resources/allocator.npy", npy_array_mode::load_c_order};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(huge_loaded.data()) % npy_huge_page_size, 0);
+    EXPECT_TRUE(std::equal(huge_loaded.cbegin(), huge_loaded.cend(), huge.cbegin()));
+
+    // A stateful allocator is forwarded to the task of an asynchronous load.
+    counting_allocator<double> counting{};
+    npy_array<double, counting_allocator<double>> counted =
+        npy_array<double, counting_allocator<double>>::async_load("./test_resources/allocator.npy", npy_array_mode::load_in_memory,
+                                                                  npy_thread_pool::io(), counting).get();
+    EXPECT_EQ(counted.get_allocator(), counting);
+    EXPECT_GE(*counting.allocated, huge.byte_size());
+    EXPECT_TRUE(std::equal(counted.cbegin(), counted.cend(), huge.cbegin()));
+
+    // It is given to the converting loads, whether the dtype matches or not, and to the reads of rows as well.
+    counting_allocator<float> float_counting{};
+    npy_array<float, counting_allocator<float>> converted =
+        npy_array<float, counting_allocator<float>>::load_converted("./test_resources/allocator.npy", npy_cast::cast_unchecked, float_counting);
+    EXPECT_EQ(converted.get_allocator(), float_counting);
+    EXPECT_EQ(*float_counting.allocated, converted.byte_size());
+    EXPECT_FLOAT_EQ(converted[1000], 1000.0f);
+
+    *counting.allocated = 0;
+    npy_array<double, counting_allocator<double>> same =
+        npy_array<double, counting_allocator<double>>::load_converted("./test_resources/allocator.npy", npy_cast::cast_unchecked, counting);
+    EXPECT_EQ(same.get_allocator(), counting);
+    EXPECT_EQ(*counting.allocated, huge.byte_size());
+
+    *counting.allocated = 0;
+    npy_array<double, counting_allocator<double>> range =
+        npy_array<double, counting_allocator<double>>::load_rows("./test_resources/allocator.npy", 10, 2, npy_thread_pool::shared(), counting);
+    EXPECT_EQ(range.get_allocator(), counting);
+    EXPECT_EQ(*counting.allocated, range.byte_size());
+    EXPECT_EQ(range(1, 3), huge(11, 3));
+
+    *counting.allocated = 0;
+    npy_array<double, counting_allocator<double>> gathered =
+        npy_array<double, counting_allocator<double>>::load_rows("./test_resources/allocator.npy", {7, 3, 7}, npy_thread_pool::shared(), counting);
+    EXPECT_EQ(gathered.get_allocator(), counting);
+    EXPECT_EQ(*counting.allocated, gathered.byte_size());
+    EXPECT_EQ(gathered(1, 5), huge(3, 5));
+
+    std::remove("./test_resources/allocator.npy");
+}
+
+TEST(NPYArrayTest, UninitializedTest)
+{
+    npy_array<int> array = npy_array<int>::uninitialized({4, 5});
+    EXPECT_EQ(array.shape(), (std::vector<size_t>{4, 5}));
+    EXPECT_EQ(array.size(), 20);
+    EXPECT_FALSE(array.fortran_order());
+
+    std::iota(array.begin(), array.end(), 0);
+    EXPECT_EQ(array.at({3, 4}), 19);
+
+    npy_array<float, npy_aligned_allocator<float>> aligned = npy_array<float, npy_aligned_allocator<float>>::uninitialized({1000});
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned.data()) % 64, 0);
+
+    // The shape constructors still zero the payload.
+    npy_array<double> zeros{{100}};
+    EXPECT_TRUE(std::all_of(zeros.cbegin(), zeros.cend(), [](double value) {return value == 0.0;}));
+
+    // The elements constructed with a value are still initialized with it.
+    std::vector<int, npy_default_init_allocator<std::allocator<int>>> values{};
+    values.resize(10, 7);
+    EXPECT_TRUE(std::all_of(values.cbegin(), values.cend(), [](int value) {return value == 7;}));
+
+    try
+    {
+        npy_array<std::string>::uninitialized({2});
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_dtype);
+    }
+}
+
+TEST(NPYArrayTest, AccessorTest)
+{
+    npy_array<int> array{{3, 4, 5}};
+    std::iota(array.begin(), array.end(), 0);
+
+    npy_accessor<int, 3> accessor = array.accessor<3>();
+    EXPECT_EQ(accessor.shape(), (std::array<size_t, 3>{{3, 4, 5}}));
+    EXPECT_EQ(accessor.strides(), (std::array<size_t, 3>{{20, 5, 1}}));
+
+    for(size_t i = 0; i < 3; i++)
+    {
+        for(size_t j = 0; j < 4; j++)
+        {
+            for(size_t k = 0; k < 5; k++)
+            {
+                EXPECT_EQ(accessor(i, j, k), (array[{i, j, k}]));
+                EXPECT_EQ(array(i, j, k), (array[{i, j, k}]));
+            }
+        }
+    }
+
+    accessor(2, 3, 4) = -1;
+    EXPECT_EQ(array.at({2, 3, 4}), -1);
+    array(0, 1, 2) = -2;
+    EXPECT_EQ(accessor.at(0, 1, 2), -2);
+
+    const npy_array<int>& constant = array;
+    npy_accessor<const int, 3> constant_accessor = constant.accessor<3>();
+    EXPECT_EQ(constant_accessor(1, 2, 3), 33);
+    EXPECT_EQ(constant(1, 2, 3), 33);
+    EXPECT_EQ(constant.at({1, 2, 3}), 33);
+
+    try
+    {
+        accessor.at(0, 4, 0);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    // The checked indexing of the array, which verifies the number of indexes too.
+    EXPECT_EQ(array.at(0, 1, 2), -2);
+    EXPECT_EQ(constant.at(1, 2, 3), 33);
+
+    for(std::vector<size_t> indexes : {std::vector<size_t>{0, 4, 0}, std::vector<size_t>{3, 0, 0}, std::vector<size_t>{0, 0, 5}})
+    {
+        try
+        {
+            array.at(indexes[0], indexes[1], indexes[2]);
+            FAIL();
+        }
+        catch(const std::out_of_range& e) {}
+    }
+
+    try
+    {
+        array.at(0, 1);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    try
+    {
+        constant.at(0, 1, 2, 0);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    try
+    {
+        array.accessor<2>();
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+
+    // The Fortran-ordered payloads are accessed with their own strides.
+    std::string preamble = npy_header{npy_dtype::int_32(), true, {2, 3}}.str();
+    std::vector<int> fortran_payload{{0, 10, 1, 11, 2, 12}};
+    std::ofstream fortran_file{"./test_resources/accessor.npy", std::ios_base::binary};
+    fortran_file.write(preamble.data(), preamble.size());
+    fortran_file.write(reinterpret_cast<const char*>(fortran_payload.data()), fortran_payload.size() * sizeof(int));
+    fortran_file.close();
+
+    npy_array<int> fortran{"./test_resources/accessor.npy"};
+    std::remove("./test_resources/accessor.npy");
+
+    npy_accessor<int, 2> fortran_accessor = fortran.accessor<2>();
+    EXPECT_EQ(fortran_accessor(1, 2), 12);
+    EXPECT_EQ(fortran_accessor(0, 1), 1);
+    EXPECT_EQ(fortran(1, 1), 11);
+}
+
+TEST(NPYArrayTest, ParallelIOTest)
+{
+    npy_array<int64_t> matrix{{1000, 1500}};
+    std::iota(matrix.begin(), matrix.end(), int64_t(-5000));
+
+    npy_thread_pool pool{8};
+
+    for(npy_endianness byte_order : {npy_endianness::native, npy_endianness::big_endian})
+    {
+        npy_save_options options{};
+        options.byte_order = byte_order;
+        options.parallel = true;
+        options.pool = &pool;
+        matrix.save("./test_resources/parallel.npy", options);
+
+        // The file is the same as the one written by a single stream.
+        matrix.save("./test_resources/sequential.npy", byte_order);
+        std::ifstream parallel_file{"./test_resources/parallel.npy", std::ios_base::binary};
+        std::ifstream sequential_file{"./test_resources/sequential.npy", std::ios_base::binary};
+        EXPECT_TRUE(std::equal(std::istreambuf_iterator<char>{parallel_file}, std::istreambuf_iterator<char>{},
+                               std::istreambuf_iterator<char>{sequential_file}, std::istreambuf_iterator<char>{}));
+
+        npy_array<int64_t> loaded{"./test_resources/parallel.npy", npy_array_mode::load_parallel, pool};
+        EXPECT_EQ(loaded.shape(), matrix.shape());
+        EXPECT_TRUE(std::equal(loaded.cbegin(), loaded.cend(), matrix.cbegin()));
+
+        npy_array<int64_t> shared_loaded{"./test_resources/parallel.npy", npy_array_mode::load_parallel};
+        EXPECT_TRUE(std::equal(shared_loaded.cbegin(), shared_loaded.cend(), matrix.cbegin()));
+    }
+
+    // Ranges of one page, the first and the last ones being partial.
+    std::string content(5 * npy_direct_alignment + 77, '\0');
+    for(size_t i = 0; i < content.size(); i++)
+    {
+        content[i] = static_cast<char>(i * 13);
+    }
+
+    npy_parallel_write("./test_resources/parallel.npy", std::string(192, 'h'), content.data(), content.size(), pool, 1);
+
+    std::string read(content.size() + 100, '\0');
+    npy_parallel_read("./test_resources/parallel.npy", 92, &read[0], read.size(), pool, 1);
+    EXPECT_EQ(read.substr(0, 100), std::string(100, 'h'));
+    EXPECT_EQ(read.substr(100), content);
+
+    try
+    {
+        npy_parallel_read("./test_resources/parallel.npy", 92, &read[0], read.size() + 1, pool, 1);
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+
+    std::remove("./test_resources/parallel.npy");
+    std::remove("./test_resources/sequential.npy");
+}
+
+TEST(NPYArrayTest, SaveAtomicTest)
+{
+    npy_array<float> old_array{{100}};
+    old_array.save("./test_resources/atomic.npy");
+
+    // A reader mapping the previous file keeps seeing it whole.
+    npy_array<float> mapped{"./test_resources/atomic.npy", npy_array_mode::map_read_only};
+
+    npy_array<float> new_array{{10, 20}};
+    std::iota(new_array.begin(), new_array.end(), 1.0f);
+
+    npy_save_options options{};
+    options.sync = true;
+    new_array.save("./test_resources/atomic.npy", options);
+
+    EXPECT_EQ(mapped.shape(), (std::vector<size_t>{100}));
+    EXPECT_TRUE(std::all_of(mapped.cbegin(), mapped.cend(), [](float value) {return value == 0.0f;}));
+
+    npy_array<float> loaded{"./test_resources/atomic.npy"};
+    EXPECT_EQ(loaded.shape(), new_array.shape());
+    EXPECT_TRUE(std::equal(loaded.cbegin(), loaded.cend(), new_array.cbegin()));
+
+    // In place, like the saves used to be.
+    options.atomic = false;
+    options.byte_order = npy_endianness::big_endian;
+    new_array.save("./test_resources/atomic.npy", options);
+    npy_array<float> swapped = npy_array<float>::load_converted("./test_resources/atomic.npy");
+    EXPECT_TRUE(std::equal(swapped.cbegin(), swapped.cend(), new_array.cbegin()));
+
+    // The permissions of the replaced file are kept.
+    options = npy_save_options{};
+    ::chmod("./test_resources/atomic.npy", 0600);
+    new_array.save("./test_resources/atomic.npy", options);
+
+    struct stat status;
+    ASSERT_EQ(::stat("./test_resources/atomic.npy", &status), 0);
+    EXPECT_EQ(status.st_mode & 07777, 0600);
+
+    // A symbolic link is kept, and points to the new file.
+    ASSERT_EQ(::symlink("atomic.npy", "./test_resources/atomic_link.npy"), 0);
+    old_array.save("./test_resources/atomic_link.npy", options);
+
+    ASSERT_EQ(::lstat("./test_resources/atomic_link.npy", &status), 0);
+    EXPECT_TRUE(S_ISLNK(status.st_mode));
+    EXPECT_EQ(npy_array<float>{"./test_resources/atomic.npy"}.shape(), old_array.shape());
+    std::remove("./test_resources/atomic_link.npy");
+
+    // A path that is not a regular file is written in place.
+    old_array.save("/dev/null", options);
+
+    // New files are created with the permissions left by the umask, whatever the way they are written.
+    const mode_t mask = ::umask(0002);
+
+    for(int way = 0; way < 4; way++)
+    {
+        std::remove("./test_resources/atomic.npy");
+
+        options = npy_save_options{};
+        options.atomic = way == 0;
+        options.direct = way == 2;
+        options.parallel = way == 3;
+        new_array.save("./test_resources/atomic.npy", options);
+
+        ASSERT_EQ(::stat("./test_resources/atomic.npy", &status), 0);
+        EXPECT_EQ(status.st_mode & 07777, 0664);
+    }
+
+    ::umask(mask);
+
+    for(bool atomic : {true, false})
+    {
+        try
+        {
+            options.atomic = atomic;
+            new_array.save("./test_resources/missing/atomic.npy", options);
+            FAIL();
+        }
+        catch(const npy_array_exception& e)
+        {
+            EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+        }
+    }
+
+    std::remove("./test_resources/atomic.npy");
+}
+
+TEST(NPYArrayTest, RowReadTest)
+{
+    npy_array<int32_t> matrix{{200, 3, 5}};
+    std::iota(matrix.begin(), matrix.end(), 0);
+
+    npy_thread_pool pool{4};
+
+    auto expect_rows = [&matrix](const npy_array<int32_t>& loaded, const std::vector<size_t>& rows)
+    {
+        ASSERT_EQ(loaded.shape(), (std::vector<size_t>{rows.size(), 3, 5}));
+
+        for(size_t i = 0; i < rows.size(); i++)
+        {
+            EXPECT_TRUE(std::equal(loaded.cbegin() + i * 15, loaded.cbegin() + (i + 1) * 15, matrix.cbegin() + rows[i] * 15));
+        }
+    };
+
+    for(npy_endianness byte_order : {npy_endianness::native, npy_endianness::big_endian})
+    {
+        matrix.save("./test_resources/rows.npy", byte_order);
+
+        npy_array<int32_t> range = npy_array<int32_t>::load_rows("./test_resources/rows.npy", 37, 100, pool);
+        std::vector<size_t> range_rows(100);
+        std::iota(range_rows.begin(), range_rows.end(), size_t(37));
+        expect_rows(range, range_rows);
+
+        EXPECT_EQ(npy_array<int32_t>::load_rows("./test_resources/rows.npy", 200, 0).shape(), (std::vector<size_t>{0, 3, 5}));
+
+        // Unsorted, repeated, and adjacent rows, in and out of order.
+        std::vector<size_t> rows{5, 6, 7, 199, 0, 42, 41, 40, 6, 100, 101, 5, 150};
+        expect_rows(npy_array<int32_t>::load_rows("./test_resources/rows.npy", rows, pool), rows);
+        expect_rows(npy_array<int32_t>::load_rows("./test_resources/rows.npy", std::vector<size_t>{}), {});
+    }
+
+    try
+    {
+        npy_array<int32_t>::load_rows("./test_resources/rows.npy", 150, 51);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    try
+    {
+        npy_array<int32_t>::load_rows("./test_resources/rows.npy", std::vector<size_t>{3, 200, 4});
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    try
+    {
+        npy_array<int64_t>::load_rows("./test_resources/rows.npy", 0, 1);
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+    }
+
+    npy_array<int32_t> scalar{std::vector<size_t>{}};
+    scalar.save("./test_resources/rows.npy");
+
+    try
+    {
+        npy_array<int32_t>::load_rows("./test_resources/rows.npy", std::vector<size_t>{0});
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_layout);
+    }
+
+    std::remove("./test_resources/rows.npy");
+}
+
+TEST(NPYArrayTest, EmptyTest)
+{
+    // The files of empty arrays, like the ones of np.zeros((0, 3)), are loaded in every mode.
+    npy_array<float> empty{{0, 3}};
+    empty.save("./test_resources/empty.npy");
+
+    EXPECT_EQ(npy_header::probe("./test_resources/empty.npy").shape(), (std::vector<size_t>{0, 3}));
+
+    for(npy_array_mode mode : {npy_array_mode::load_in_memory, npy_array_mode::map_read_only, npy_array_mode::load_c_order,
+                               npy_array_mode::load_direct, npy_array_mode::load_parallel})
+    {
+        npy_array<float> loaded{"./test_resources/empty.npy", mode};
+        EXPECT_EQ(loaded.shape(), (std::vector<size_t>{0, 3}));
+        EXPECT_EQ(loaded.size(), 0);
+    }
+
+    EXPECT_EQ(npy_array<float>::load_rows("./test_resources/empty.npy", std::vector<size_t>{}).shape(), (std::vector<size_t>{0, 3}));
+
+    std::remove("./test_resources/empty.npy");
+}
+
+TEST(NPYArrayTest, OverflowingShapeTest)
+{
+    // A crafted shape whose number of elements wraps around would otherwise pass the bound of the mapping, and size the buffers.
+    std::string preamble = npy_header{npy_dtype::float_32(), false, {size_t(1) << 62, 8}}.str();
+    std::ofstream overflow_file{"./test_resources/overflow.npy", std::ios_base::binary};
+    overflow_file.write(preamble.data(), preamble.size());
+    overflow_file.write(std::string(64, '\0').data(), 64);
+    overflow_file.close();
+
+    for(npy_array_mode mode : {npy_array_mode::load_in_memory, npy_array_mode::map_read_only, npy_array_mode::load_direct,
+                               npy_array_mode::load_parallel})
+    {
+        try
+        {
+            npy_array<float> loaded{"./test_resources/overflow.npy", mode};
+            FAIL();
+        }
+        catch(const npy_array_exception& e)
+        {
+            EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+        }
+    }
+
+    std::remove("./test_resources/overflow.npy");
+}
 
 int main(int argc, char* argv[])
 {
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <stdexcept>
+
+#include "npy_array/npy_batch.h"
+#include "npy_array/npz_archive.h"
+
+class NPYBatchTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        for(size_t i = 0; i < file_count; i++)
+        {
+            npy_array<int> matrix{{3, 4}};
+
+            for(size_t j = 0; j < matrix.size(); j++)
+            {
+                matrix[j] = static_cast<int>(i * 100 + j);
+            }
+
+            paths.push_back("./test_resources/batch_" + std::to_string(i) + ".npy");
+
+            // Mix byte orders, so that some payloads are swapped while they are read.
+            matrix.save(paths.back(), i % 2 == 0 ? npy_endianness::little_endian : npy_endianness::big_endian);
+        }
+
+        npy_array<int>{{4, 3}}.save("./test_resources/batch_transposed.npy");
+    }
+
+    void TearDown() override
+    {
+        for(const auto& path : paths)
+        {
+            std::remove(path.c_str());
+        }
+
+        std::remove("./test_resources/batch_transposed.npy");
+    }
+
+    const size_t file_count = 50;
+    std::vector<std::string> paths{};
+};
+
+TEST_F(NPYBatchTest, LoadBatchTest)
+{
+    std::vector<std::string> batch_paths{paths};
+    batch_paths.push_back("./test_resources/missing.npy");
+    batch_paths.push_back("./test_resources/fake_dtype.npy");
+    batch_paths.push_back("./test_resources/types/float32.npy");
+
+    // A pool with more threads than files, as for latency-bound loads.
+    npy_thread_pool io_pool{64};
+    std::vector<npy_batch_item<int>> items = npy_load_batch<int>(batch_paths, npy_array_mode::load_in_memory, io_pool);
+
+    ASSERT_EQ(items.size(), batch_paths.size());
+
+    for(size_t i = 0; i < file_count; i++)
+    {
+        ASSERT_TRUE(static_cast<bool>(items[i].array));
+        EXPECT_EQ(items[i].array->shape(), (std::vector<size_t>{3, 4}));
+        EXPECT_EQ(items[i].array->at({2, 3}), static_cast<int>(i * 100 + 11));
+    }
+
+    EXPECT_FALSE(items[file_count].array);
+    EXPECT_EQ(items[file_count].error, npy_array_exception_type::input_output_error);
+    EXPECT_FALSE(items[file_count + 1].array);
+    EXPECT_EQ(items[file_count + 1].error, npy_array_exception_type::ill_formed_header);
+    EXPECT_FALSE(items[file_count + 2].array);
+    EXPECT_EQ(items[file_count + 2].error, npy_array_exception_type::ill_formed_header);
+
+    std::vector<npy_batch_item<int>> fortran_items = npy_load_batch<int>({"./test_resources/stored.npz", paths[0]}, npy_array_mode::load_c_order);
+    EXPECT_FALSE(fortran_items[0].array);
+    EXPECT_EQ(fortran_items[1].array->at({1, 0}), 4);
+}
+
+TEST_F(NPYBatchTest, LoadStackedTest)
+{
+    npy_array<int> stacked = npy_load_stacked<int>(paths);
+
+    EXPECT_EQ(stacked.shape(), (std::vector<size_t>{file_count, 3, 4}));
+    EXPECT_FALSE(stacked.fortran_order());
+
+    for(size_t i = 0; i < file_count; i++)
+    {
+        EXPECT_EQ(stacked.at({i, 0, 0}), static_cast<int>(i * 100));
+        EXPECT_EQ(stacked.at({i, 1, 2}), static_cast<int>(i * 100 + 6));
+    }
+
+    try
+    {
+        npy_load_stacked<int>({paths[0], "./test_resources/batch_transposed.npy"});
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unmatched_shape_data);
+    }
+
+    try
+    {
+        npy_load_stacked<int>({paths[0], "./test_resources/missing.npy", "./test_resources/batch_transposed.npy"});
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+
+    try
+    {
+        npy_load_stacked<int>({});
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+}
+
+TEST_F(NPYBatchTest, LoadStackedFortranTest)
+{
+    // The Fortran-ordered arrays are stacked in C order.
+    npz_archive archive{"./test_resources/stored.npz"};
+    archive.load<int>("fortran").save("./test_resources/batch_transposed.npy");
+    archive.load<int>("fortran", npy_array_mode::load_c_order).save(paths[0]);
+
+    npy_array<int> stacked = npy_load_stacked<int>({paths[0], "./test_resources/batch_transposed.npy"});
+    ASSERT_EQ(stacked.shape()[0], 2);
+    EXPECT_TRUE(std::equal(stacked.cbegin(), stacked.cbegin() + stacked.size() / 2, stacked.cbegin() + stacked.size() / 2));
+    EXPECT_EQ(stacked.at({1, 1, 2}), 12);
+}
+
+TEST_F(NPYBatchTest, ProbeBatchTest)
+{
+    npy_header header = npy_header::probe(paths[1]);
+    EXPECT_EQ(header.shape(), (std::vector<size_t>{3, 4}));
+    EXPECT_EQ(header.dtype(), npy_dtype::int_32().with_byte_order(npy_endianness::big_endian));
+    EXPECT_FALSE(header.fortran_order());
+    EXPECT_EQ(header.major_version(), 1);
+    EXPECT_EQ(header.payload_offset(), 128);
+
+    // A header longer than the first read.
+    std::vector<size_t> long_shape(300, 1);
+    npy_array<uint8_t>{long_shape}.save("./test_resources/batch_transposed.npy");
+
+    std::vector<std::string> probe_paths{paths};
+    probe_paths.push_back("./test_resources/batch_transposed.npy");
+    probe_paths.push_back("./test_resources/missing.npy");
+    probe_paths.push_back("./test_resources/fake_dtype.npy");
+
+    std::vector<npy_probe_item> items = npy_probe_batch(probe_paths);
+    ASSERT_EQ(items.size(), probe_paths.size());
+
+    for(size_t i = 0; i < file_count; i++)
+    {
+        ASSERT_TRUE(items[i].probed);
+        EXPECT_EQ(items[i].header.shape(), (std::vector<size_t>{3, 4}));
+        EXPECT_EQ(items[i].header.byte_size(), 48);
+    }
+
+    ASSERT_TRUE(items[file_count].probed);
+    EXPECT_EQ(items[file_count].header.shape(), long_shape);
+    EXPECT_EQ(items[file_count].header.payload_offset(), npy_header(npy_dtype::uint_8(), false, long_shape).payload_offset());
+
+    EXPECT_FALSE(items[file_count + 1].probed);
+    EXPECT_EQ(items[file_count + 1].error, npy_array_exception_type::input_output_error);
+    EXPECT_FALSE(items[file_count + 2].probed);
+    EXPECT_EQ(items[file_count + 2].error, npy_array_exception_type::ill_formed_header);
+
+    try
+    {
+        npy_header::probe("./test_resources/missing.npy");
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -293,6 +293,7 @@ TEST(NPYDtypeTest, FromString)
     EXPECT_EQ(npy_dtype::from_string(npy_dtype::uint_16().str()), npy_dtype::uint_16());
     EXPECT_EQ(npy_dtype::from_string(npy_dtype::uint_32().str()), npy_dtype::uint_32());
     EXPECT_EQ(npy_dtype::from_string(npy_dtype::uint_64().str()), npy_dtype::uint_64());
+    EXPECT_EQ(npy_dtype::from_string(npy_dtype::float_16().str()), npy_dtype::float_16());
     EXPECT_EQ(npy_dtype::from_string(npy_dtype::float_32().str()), npy_dtype::float_32());
     EXPECT_EQ(npy_dtype::from_string(npy_dtype::float_64().str()), npy_dtype::float_64());
     EXPECT_EQ(npy_dtype::from_string(npy_dtype::float_128().str()),  npy_dtype::float_128());
@@ -301,6 +302,35 @@ TEST(NPYDtypeTest, FromString)
     EXPECT_EQ(npy_dtype::from_string(npy_dtype::complex_256().str()),  npy_dtype::complex_256());
 }
 
+TEST(NPYDtypeTest, WithByteOrder)
+{
+    EXPECT_EQ(npy_dtype::int_32().with_byte_order(npy_endianness::big_endian).str(), ">i4");
+    EXPECT_EQ(npy_dtype::from_string(">f8").with_byte_order(npy_endianness::native), npy_dtype::float_64());
+    EXPECT_EQ(npy_dtype::complex_64().with_byte_order(get_endianess()), npy_dtype::complex_64());
+    EXPECT_EQ(npy_dtype::uint_8().with_byte_order(npy_endianness::big_endian), npy_dtype::uint_8());
+    EXPECT_EQ(npy_dtype::null().with_byte_order(npy_endianness::big_endian), npy_dtype::null());
+}
+
+TEST(NPYDtypeTest, ConstantExpressionTest)
+{
+    static_assert(npy_dtype::from_type<double>() == npy_dtype::float_64(), "from_type is not constexpr");
+    static_assert(!npy_dtype::from_type<std::string>(), "from_type is not constexpr");
+    static_assert(npy_dtype::from_string("<c16") == npy_dtype::complex_128().with_byte_order(npy_endianness::little_endian), "from_string is not constexpr");
+    static_assert(npy_dtype::from_string("|b1") == npy_dtype::bool_8(), "from_string is not constexpr");
+    static_assert(!npy_dtype::from_string("<i16"), "from_string is not constexpr");
+    static_assert(npy_dtype::float_128().descr().size() == 4, "descr is not constexpr");
+
+    constexpr npy_dtype_string dtype_string = npy_dtype::uint_16().with_byte_order(npy_endianness::big_endian).descr();
+    EXPECT_STREQ(dtype_string.c_str(), ">u2");
+
+    // The pointer overload does not need a null terminated string.
+    const char buffer[] = {'>', 'f', '4', '>', 'f', '8'};
+    EXPECT_EQ(npy_dtype::from_string(buffer + 3, 3), npy_dtype::float_64().with_byte_order(npy_endianness::big_endian));
+    EXPECT_EQ(npy_dtype::from_string(buffer, 2), npy_dtype::float_64().with_byte_order(npy_endianness::big_endian));
+    EXPECT_EQ(npy_dtype::from_string("f0"), npy_dtype::null());
+    EXPECT_EQ(npy_dtype::from_string("=c08"), npy_dtype::null());
+}
+
 int main(int argc, char* argv[])
 {
     testing::InitGoogleTest(&argc, argv);
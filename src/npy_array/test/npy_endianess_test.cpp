@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include <endian.h>
+#include <complex>
+#include <cstring>
+#include <numeric>
 
 #include "npy_array/endianess.h"
+#include "npy_array/npy_byteswap.h"
 
 TEST(NPYEndianessTest, MachineEndianessCorrectnessTest)
 {
@@ -20,6 +24,52 @@ TEST(NPYEndianessTest, MachineEndianessCorrectnessTest)
         FAIL();
     }
 }
+TEST(NPYEndianessTest, ByteswapTest)
+{
+    // An odd number of bytes exercises the vectorized loops and the scalar tail.
+    std::vector<uint8_t> bytes(16 * 37 + 16);
+    std::iota(bytes.begin(), bytes.end(), 0);
+
+    for(size_t unit_size : {1, 2, 4, 8, 16})
+    {
+        size_t count = (bytes.size() - 16) / unit_size + 1;
+        std::vector<uint8_t> swapped{bytes};
+        npy_byteswap(swapped.data(), count, unit_size);
+
+        for(size_t i = 0; i < count * unit_size; i++)
+        {
+            size_t unit_start = i / unit_size * unit_size;
+            EXPECT_EQ(swapped[i], bytes[unit_start + unit_size - 1 - (i - unit_start)]);
+        }
+
+        EXPECT_TRUE(std::equal(swapped.cbegin() + count * unit_size, swapped.cend(), bytes.cbegin() + count * unit_size));
+
+        npy_byteswap(swapped.data(), count, unit_size);
+        EXPECT_EQ(swapped, bytes);
+    }
+
+    std::vector<uint32_t> values{{0x01020304, 0xAABBCCDD, 0x00000001}};
+    npy_byteswap(values.data(), values.size(), npy_dtype::uint_32());
+    EXPECT_EQ(values, std::vector<uint32_t>({0x04030201, 0xDDCCBBAA, 0x01000000}));
+}
+
+TEST(NPYEndianessTest, ComplexByteswapTest)
+{
+    std::vector<std::complex<float>> values(9, std::complex<float>{1.5f, -2.0f});
+    npy_byteswap(values.data(), values.size(), npy_dtype::complex_64());
+
+    float real = 1.5f;
+    float swapped_real;
+    uint32_t bits;
+    std::memcpy(&bits, &real, sizeof(float));
+    bits = __builtin_bswap32(bits);
+    std::memcpy(&swapped_real, &bits, sizeof(float));
+
+    EXPECT_EQ(std::memcmp(&values[8], &swapped_real, sizeof(float)), 0);
+
+    npy_byteswap(values.data(), values.size(), npy_dtype::complex_64());
+    EXPECT_EQ(values[8], std::complex<float>(1.5f, -2.0f));
+}
 
 int main(int argc, char* argv[])
 {
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include "npy_array/npy_header.h"
+
+namespace
+{
+    npy_header parse(const std::string& dictionary)
+    {
+        return npy_header::from_dictionary(dictionary.data(), dictionary.size());
+    }
+
+    void expect_ill_formed(const std::string& dictionary)
+    {
+        try
+        {
+            parse(dictionary);
+            ADD_FAILURE() << dictionary;
+        }
+        catch(const npy_array_exception& e)
+        {
+            EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header) << dictionary;
+        }
+    }
+}
+
+TEST(NPYHeaderTest, DictionaryTest)
+{
+    npy_header header = parse("{'descr': '<f4', 'fortran_order': False, 'shape': (1, 256, 13, 13), }                \n");
+    EXPECT_EQ(header.dtype(), npy_dtype::float_32().with_byte_order(npy_endianness::little_endian));
+    EXPECT_FALSE(header.fortran_order());
+    EXPECT_EQ(header.shape(), (std::vector<size_t>{1, 256, 13, 13}));
+    EXPECT_EQ(header.header_length(), 86);
+
+    // Any key order, quotes, and whitespace.
+    header = parse("{ \"shape\" :(3L,4L) ,\t'fortran_order':True,\n'descr':\">u2\"}");
+    EXPECT_EQ(header.dtype().str(), ">u2");
+    EXPECT_TRUE(header.fortran_order());
+    EXPECT_EQ(header.shape(), (std::vector<size_t>{3, 4}));
+
+    // A 1-tuple and a 0-d shape.
+    EXPECT_EQ(parse("{'descr': '|b1', 'fortran_order': False, 'shape': (5,)}").shape(), std::vector<size_t>{5});
+    EXPECT_EQ(parse("{'descr': '|b1', 'fortran_order': False, 'shape': ( )}").shape(), std::vector<size_t>{});
+    EXPECT_EQ(parse("{'descr': '|b1', 'fortran_order': False, 'shape': ()}").size(), 1);
+
+    // An empty array, like np.zeros((0, 2)).
+    header = parse("{'descr': '<f4', 'fortran_order': False, 'shape': (0, 2)}");
+    EXPECT_EQ(header.shape(), (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(header.size(), 0);
+    EXPECT_EQ(header.byte_size(), 0);
+
+    // The empty dimension keeps the other ones from overflowing.
+    EXPECT_EQ(parse("{'descr': '<f4', 'fortran_order': False, 'shape': (4611686018427387904, 8, 0)}").byte_size(), 0);
+
+    // The header written by str() is read back.
+    npy_header written{npy_dtype::complex_128(), true, {7, 1, 3}};
+    std::string preamble = written.str();
+    header = parse(preamble.substr(written.payload_offset() - written.header_length()));
+    EXPECT_EQ(header.dtype(), written.dtype());
+    EXPECT_EQ(header.fortran_order(), written.fortran_order());
+    EXPECT_EQ(header.shape(), written.shape());
+
+    std::istringstream preamble_stream{preamble};
+    EXPECT_EQ(npy_header::read(preamble_stream).shape(), written.shape());
+
+    // More dimensions than the ones parsed on the stack, few of them above 1 so that the size fits.
+    std::string long_shape{"{'descr': '<f4', 'fortran_order': False, 'shape': ("};
+    for(size_t i = 0; i < 100; i++) long_shape.append(std::to_string(i % 18 == 9 ? i + 1 : 1) + ", ");
+    header = parse(long_shape + ")}");
+    EXPECT_EQ(header.shape().size(), 100);
+    EXPECT_EQ(header.shape()[63], 64);
+    EXPECT_EQ(header.shape()[99], 100);
+    EXPECT_EQ(header.size(), size_t(10) * 28 * 46 * 64 * 82 * 100);
+}
+
+TEST(NPYHeaderTest, IllFormedDictionaryTest)
+{
+    expect_ill_formed("");
+    expect_ill_formed("{}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (5)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (,)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (1,,2)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (02,)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (-2,)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (99999999999999999999999,)}");
+    // Shapes whose number of elements, (2**62, 8), or of bytes, (2**61, 4) of 8 bytes, does not fit in a size_t.
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (4611686018427387904, 8)}");
+    expect_ill_formed("{'descr': '<f8', 'fortran_order': False, 'shape': (2305843009213693952, 4)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (2,), 'shape': (2,)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (2,), 'extra': 1}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': Falsey, 'shape': (2,)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': 0, 'shape': (2,)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (2,)} x");
+    expect_ill_formed("{'descr': '<f4' 'fortran_order': False, 'shape': (2,)}");
+    expect_ill_formed("{'descr': '<f4\", 'fortran_order': False, 'shape': (2,)}");
+    expect_ill_formed("{'descr': [('a', '<f4')], 'fortran_order': False, 'shape': (2,)}");
+    expect_ill_formed("{'descr': '<f4', 'fortran_order': False, 'shape': (2,)");
+}
+
+TEST(NPYHeaderTest, FuzzTest)
+{
+    // Every invalid dtype string makes the header ill formed, every valid one is accepted.
+    std::ifstream invalid_dtype_strings_file{"./test_resources/invalid_dtype_strings.txt"};
+    std::string dtype_string{};
+
+    while(std::getline(invalid_dtype_strings_file, dtype_string))
+    {
+        expect_ill_formed("{'descr': '" + dtype_string + "', 'fortran_order': False, 'shape': (2, 3), }");
+    }
+
+    std::ifstream valid_dtype_strings_file{"./test_resources/valid_dtype_strings.txt"};
+
+    while(std::getline(valid_dtype_strings_file, dtype_string))
+    {
+        EXPECT_EQ(parse("{'shape': (2, 3), 'descr': '" + dtype_string + "', 'fortran_order': False}").dtype(), npy_dtype::from_string(dtype_string));
+    }
+
+    // Truncated and mutated dictionaries are either parsed or rejected as ill formed, the parser never reads past the end.
+    const std::string dictionary{"{'descr': '<i8', 'fortran_order': True, 'shape': (10, 2,), }  \n"};
+    const std::string alphabet{"{}()[]:,'\" \n0123456789LTrueFalse<>|=iufcb"};
+    std::mt19937 generator{42};
+
+    for(size_t length = 0; length <= dictionary.find('}'); length++)
+    {
+        expect_ill_formed(dictionary.substr(0, length));
+    }
+
+    for(size_t i = 0; i < 20000; i++)
+    {
+        std::string mutated{dictionary};
+        size_t mutations = 1 + generator() % 4;
+
+        for(size_t j = 0; j < mutations; j++)
+        {
+            mutated[generator() % mutated.size()] = alphabet[generator() % alphabet.size()];
+        }
+
+        // Parse a copy without terminator, so that reading past the end is caught by the sanitizers.
+        std::unique_ptr<char[]> characters{new char[mutated.size()]};
+        std::copy(mutated.cbegin(), mutated.cend(), characters.get());
+
+        try
+        {
+            npy_header header = npy_header::from_dictionary(characters.get(), mutated.size());
+            EXPECT_TRUE(static_cast<bool>(header.dtype()));
+        }
+        catch(const npy_array_exception& e)
+        {
+            EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+        }
+    }
+}
+
+TEST(NPYHeaderTest, WritePreambleTest)
+{
+    npy_header header{npy_dtype::float_64().with_byte_order(npy_endianness::big_endian), true, {123456789012, 2, 7}};
+    std::string preamble = header.str();
+
+    EXPECT_EQ(preamble.size(), 128);
+    EXPECT_EQ(preamble.substr(0, 8), std::string("\x93NUMPY\x01\x00", 8));
+    EXPECT_NE(preamble.find("{'descr': '>f8', 'fortran_order': True, 'shape': (123456789012, 2, 7), }"), std::string::npos);
+    EXPECT_EQ(preamble.back(), '\n');
+
+    // Nothing is written into a buffer too small.
+    std::string buffer(preamble.size() - 1, 'x');
+    EXPECT_EQ(header.write_preamble(&buffer[0], buffer.size()), preamble.size());
+    EXPECT_EQ(buffer, std::string(preamble.size() - 1, 'x'));
+
+    buffer.assign(200, 'x');
+    EXPECT_EQ(header.write_preamble(&buffer[0], buffer.size()), preamble.size());
+    EXPECT_EQ(buffer.substr(0, preamble.size()), preamble);
+    EXPECT_EQ(buffer.substr(preamble.size()), std::string(200 - preamble.size(), 'x'));
+
+    EXPECT_EQ(header.write_preamble(nullptr, 0, 500), 512);
+    EXPECT_EQ(header.str(500).size(), 512);
+
+    // The written preamble is read back as the same header.
+    std::istringstream stream{preamble};
+    npy_header read = npy_header::read(stream);
+    EXPECT_EQ(read.dtype(), header.dtype());
+    EXPECT_EQ(read.shape(), header.shape());
+    EXPECT_TRUE(read.fortran_order());
+    EXPECT_NE(npy_header(npy_dtype::int_8(), false, {5}).str().find("(5,)"), std::string::npos);
+}
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
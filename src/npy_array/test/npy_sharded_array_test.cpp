@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <numeric>
+#include <stdexcept>
+
+#include "npy_array/npy_sharded_array.h"
+
+// Save the rows of the whole array in shards of the given number of rows, the second one in big endian.
+std::vector<std::string> save_shards(const npy_array<int32_t>& whole, const std::vector<size_t>& shard_rows)
+{
+    std::vector<std::string> paths{};
+    size_t first_row = 0;
+
+    for(size_t i = 0; i < shard_rows.size(); i++)
+    {
+        npy_array<int32_t> shard{{shard_rows[i], whole.shape()[1], whole.shape()[2]}};
+        std::copy(whole.cbegin() + first_row * 6, whole.cbegin() + (first_row + shard_rows[i]) * 6, shard.begin());
+
+        paths.push_back("./test_resources/part-" + std::to_string(i) + ".npy");
+        shard.save(paths.back(), i == 1 ? npy_endianness::big_endian : npy_endianness::native);
+        first_row += shard_rows[i];
+    }
+
+    return paths;
+}
+
+void remove_shards(const std::vector<std::string>& paths)
+{
+    for(const std::string& path : paths)
+    {
+        std::remove(path.c_str());
+    }
+}
+
+TEST(NPYShardedArrayTest, IndexTest)
+{
+    npy_array<int32_t> whole{{60, 2, 3}};
+    std::iota(whole.begin(), whole.end(), 0);
+
+    std::vector<std::string> paths = save_shards(whole, {10, 25, 0, 1, 24});
+    npy_sharded_array<int32_t> sharded{paths};
+
+    EXPECT_EQ(sharded.shape(), (std::vector<size_t>{60, 2, 3}));
+    EXPECT_EQ(sharded.size(), whole.size());
+    EXPECT_EQ(sharded.row_size(), 6);
+    EXPECT_EQ(sharded.shard_count(), 5);
+    EXPECT_EQ(sharded.shard_first_row(2), 35);
+    EXPECT_EQ(sharded.shard_first_row(4), 36);
+    EXPECT_EQ(sharded.shard_header(1).dtype(), npy_dtype::from_type<int32_t>().with_byte_order(npy_endianness::big_endian));
+    EXPECT_EQ(sharded.open_shards(), 0);
+
+    // The empty shard holds no row.
+    EXPECT_EQ(sharded.locate(0), (std::pair<size_t, size_t>{0, 0}));
+    EXPECT_EQ(sharded.locate(34), (std::pair<size_t, size_t>{1, 24}));
+    EXPECT_EQ(sharded.locate(35), (std::pair<size_t, size_t>{3, 0}));
+    EXPECT_EQ(sharded.locate(59), (std::pair<size_t, size_t>{4, 23}));
+
+    for(size_t row : {0, 9, 10, 34, 35, 36, 59})
+    {
+        npy_array<int32_t> copied = sharded.row(row);
+        EXPECT_EQ(copied.shape(), (std::vector<size_t>{2, 3}));
+        EXPECT_TRUE(std::equal(copied.cbegin(), copied.cend(), whole.cbegin() + row * 6));
+    }
+
+    // The rows of the big endian shard are read alone, without opening it.
+    EXPECT_EQ(sharded.open_shards(), 3);
+
+    try
+    {
+        sharded.locate(60);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    try
+    {
+        sharded.shard(5);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    remove_shards(paths);
+}
+
+TEST(NPYShardedArrayTest, ReadTest)
+{
+    npy_array<int32_t> whole{{60, 2, 3}};
+    std::iota(whole.begin(), whole.end(), -100);
+
+    std::vector<std::string> paths = save_shards(whole, {10, 25, 0, 1, 24});
+    npy_sharded_array<int32_t> sharded{paths, 2};
+
+    // Within a shard, and across the boundaries of the shards, the empty one included.
+    for(std::pair<size_t, size_t> range : {std::make_pair(3, 5), std::make_pair(5, 40), std::make_pair(0, 60), std::make_pair(60, 0)})
+    {
+        npy_array<int32_t> rows = sharded.load_rows(range.first, range.second);
+        EXPECT_EQ(rows.shape(), (std::vector<size_t>{range.second, 2, 3}));
+        EXPECT_TRUE(std::equal(rows.cbegin(), rows.cend(), whole.cbegin() + range.first * 6));
+    }
+
+    // The ranges do not open the shards.
+    EXPECT_EQ(sharded.open_shards(), 0);
+
+    size_t row = 0;
+
+    for(npy_view<const int32_t> view : sharded)
+    {
+        ASSERT_EQ(view.shape(), (std::vector<size_t>{2, 3}));
+        EXPECT_EQ(view.at({1, 2}), whole.at({row, 1, 2}));
+        EXPECT_EQ(view.at({0, 0}), whole.at({row, 0, 0}));
+        row++;
+    }
+
+    EXPECT_EQ(row, 60);
+    EXPECT_EQ(sharded.open_shards(), 2);
+
+    // The least recently used shard is closed, an evicted shard is kept alive by its users.
+    std::shared_ptr<const npy_array<int32_t>> first = sharded.shard(0);
+    sharded.shard(3);
+    sharded.shard(4);
+    EXPECT_EQ(sharded.open_shards(), 2);
+    EXPECT_TRUE(first->mapped());
+    EXPECT_EQ(first->at({9, 1, 2}), whole.at({9, 1, 2}));
+    EXPECT_FALSE(sharded.shard(1)->mapped());
+    EXPECT_EQ(sharded.shard(0), sharded.shard(0));
+
+    try
+    {
+        sharded.load_rows(30, 31);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    remove_shards(paths);
+}
+
+TEST(NPYShardedArrayTest, ErrorTest)
+{
+    npy_array<int32_t> whole{{20, 2, 3}};
+    std::vector<std::string> paths = save_shards(whole, {10, 10});
+
+    try
+    {
+        npy_sharded_array<int32_t> sharded{std::vector<std::string>{}};
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+
+    try
+    {
+        npy_sharded_array<int32_t> sharded{paths, 0};
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+
+    try
+    {
+        npy_sharded_array<float> sharded{paths};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+    }
+
+    try
+    {
+        npy_sharded_array<int32_t> sharded{{paths[0], "./test_resources/missing.npy"}};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+
+    npy_array<int32_t> other{{10, 3, 2}};
+    other.save(paths[1]);
+
+    try
+    {
+        npy_sharded_array<int32_t> sharded{paths};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unmatched_shape_data);
+    }
+
+    npy_array<int32_t> scalar{std::vector<size_t>{}};
+    scalar.save(paths[1]);
+
+    try
+    {
+        npy_sharded_array<int32_t> sharded{paths};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::unsupported_layout);
+    }
+
+    remove_shards(paths);
+}
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
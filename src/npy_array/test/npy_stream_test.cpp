@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "npy_array/npy_array.h"
+#include "npy_array/npy_stream_reader.h"
+#include "npy_array/npy_stream_writer.h"
+
+class NPYStreamTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::vector<int> data(10 * 3);
+        std::iota(data.begin(), data.end(), 0);
+
+        npy_array<int> matrix{{10, 3}, std::move(data)};
+        matrix.save("./test_resources/stream.npy");
+    }
+
+    void TearDown() override
+    {
+        std::remove("./test_resources/stream.npy");
+    }
+};
+
+TEST_F(NPYStreamTest, ReaderTest)
+{
+    for(bool read_ahead : {false, true})
+    {
+        npy_stream_reader<int> reader{"./test_resources/stream.npy", 4, read_ahead};
+
+        EXPECT_EQ(reader.rows(), 10);
+        EXPECT_EQ(reader.row_size(), 3);
+        EXPECT_EQ(reader.header().dtype(), npy_dtype::int_32());
+
+        std::vector<size_t> chunk_rows{};
+        int expected = 0;
+
+        while(reader.next())
+        {
+            EXPECT_EQ(reader.first_row() * 3, expected);
+            EXPECT_EQ(reader.chunk_size(), reader.chunk_rows() * 3);
+            chunk_rows.push_back(reader.chunk_rows());
+
+            for(size_t i = 0; i < reader.chunk_size(); i++)
+            {
+                EXPECT_EQ(reader.data()[i], expected++);
+            }
+        }
+
+        EXPECT_EQ(chunk_rows, std::vector<size_t>({4, 4, 2}));
+        EXPECT_EQ(expected, 30);
+        EXPECT_FALSE(reader.next());
+    }
+}
+
+TEST_F(NPYStreamTest, ReaderWholeArrayTest)
+{
+    npy_array<float> array{"./test_resources/archive.npy"};
+    npy_stream_reader<float> reader{"./test_resources/archive.npy", 100, true};
+
+    EXPECT_TRUE(reader.next());
+    EXPECT_EQ(reader.chunk_rows(), 1);
+    EXPECT_EQ(reader.chunk_size(), array.size());
+    EXPECT_TRUE(std::equal(array.cbegin(), array.cend(), reader.data()));
+    EXPECT_FALSE(reader.next());
+
+    npy_array<bool> mask{{7, 2}};
+    for(size_t i = 0; i < mask.size(); i++)
+    {
+        mask[i] = i % 3 == 0;
+    }
+
+    mask.save("./test_resources/mask.npy");
+
+    npy_stream_reader<bool> mask_reader{"./test_resources/mask.npy", 3, true};
+    size_t offset = 0;
+
+    while(mask_reader.next())
+    {
+        EXPECT_TRUE(std::equal(mask_reader.data(), mask_reader.data() + mask_reader.chunk_size(), mask.cbegin() + offset));
+        offset += mask_reader.chunk_size();
+    }
+
+    EXPECT_EQ(offset, mask.size());
+
+    std::remove("./test_resources/mask.npy");
+}
+
+TEST_F(NPYStreamTest, ReaderErrorTest)
+{
+    try
+    {
+        npy_stream_reader<float>{"./test_resources/stream.npy", 4};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+    }
+
+    try
+    {
+        npy_stream_reader<float>{"./test_resources/invalid_magic_string.npy", 4};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::invalid_magic_string);
+    }
+
+    try
+    {
+        npy_stream_reader<float>{"/test/ereregfdgdfgdgdfgfdgfgdgfdfggdf.npy", 4};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+    }
+}
+TEST_F(NPYStreamTest, WriterTest)
+{
+    // A small buffer makes both the buffered and the direct writes happen.
+    npy_stream_writer<int> writer{"./test_resources/stream_writer.npy", {3}, 5 * 3 * sizeof(int)};
+    std::vector<int> rows(3 * 8);
+    std::iota(rows.begin(), rows.end(), 0);
+
+    writer.append(rows.data(), 2);
+    writer.append(rows.data() + 2 * 3, 1);
+    writer.append(rows.data() + 3 * 3, 5);
+    writer.append(npy_array<int>{{2, 3}, {24, 25, 26, 27, 28, 29}});
+
+    EXPECT_EQ(writer.rows(), 10);
+    EXPECT_THROW(writer.append(npy_array<int>{{2, 2}}), npy_array_exception);
+
+    writer.close();
+    EXPECT_FALSE(writer.is_open());
+
+    npy_array<int> written{"./test_resources/stream_writer.npy"};
+    npy_array<int> expected{"./test_resources/stream.npy"};
+
+    EXPECT_EQ(written.shape(), expected.shape());
+    EXPECT_TRUE(std::equal(written.cbegin(), written.cend(), expected.cbegin()));
+
+    std::remove("./test_resources/stream_writer.npy");
+}
+
+TEST_F(NPYStreamTest, WriterDestructorTest)
+{
+    {
+        npy_stream_writer<float> writer{"./test_resources/stream_writer.npy", {2, 2}};
+        writer.append(npy_array<float>{{1, 2, 2}, {1.0f, 2.0f, 3.0f, 4.0f}});
+    }
+
+    npy_array<float> written{"./test_resources/stream_writer.npy"};
+    std::vector<size_t> shape{1, 2, 2};
+
+    EXPECT_EQ(written.shape(), shape);
+    EXPECT_FLOAT_EQ(written.at({0, 1, 1}), 4.0f);
+
+    std::remove("./test_resources/stream_writer.npy");
+}
+
+TEST_F(NPYStreamTest, WriterEmptyTest)
+{
+    // A writer closed without rows leaves an empty array, loaded like any other one.
+    npy_stream_writer<double> writer{"./test_resources/stream_writer.npy", {4}};
+    writer.close();
+
+    npy_array<double> written{"./test_resources/stream_writer.npy"};
+    EXPECT_EQ(written.shape(), (std::vector<size_t>{0, 4}));
+    EXPECT_EQ(written.size(), 0);
+    EXPECT_EQ(npy_header::probe("./test_resources/stream_writer.npy").shape(), (std::vector<size_t>{0, 4}));
+
+    for(bool read_ahead : {false, true})
+    {
+        npy_stream_reader<double> reader{"./test_resources/stream_writer.npy", 8, read_ahead};
+        EXPECT_EQ(reader.rows(), 0);
+        EXPECT_FALSE(reader.next());
+    }
+
+    std::remove("./test_resources/stream_writer.npy");
+}
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+
+#include "npy_array/npy_view.h"
+#include "npy_array/npz_archive.h"
+
+TEST(NPYViewTest, SliceTest)
+{
+    npy_array<int> array{{4, 5, 6}};
+    std::iota(array.begin(), array.end(), 0);
+
+    npy_view<int> view{array};
+    EXPECT_TRUE(view.contiguous());
+    EXPECT_EQ(view.strides(), (std::vector<ptrdiff_t>{30, 6, 1}));
+
+    npy_view<int> block = view.slice({npy_slice{1, 3}, npy_slice{}, npy_slice{-4, npy_slice_none, 2}});
+    EXPECT_EQ(block.shape(), (std::vector<size_t>{2, 5, 2}));
+    EXPECT_FALSE(block.contiguous());
+    EXPECT_EQ(block.offset(), 32);
+
+    for(size_t i = 0; i < 2; i++)
+    {
+        for(size_t j = 0; j < 5; j++)
+        {
+            for(size_t k = 0; k < 2; k++)
+            {
+                EXPECT_EQ(block.at({i, j, k}), array.at({i + 1, j, 2 + 2 * k}));
+            }
+        }
+    }
+
+    // Backwards, and out of range bounds clamped to the axis.
+    npy_view<int> reversed = view.slice(1, npy_slice{npy_slice_none, npy_slice_none, -2});
+    EXPECT_EQ(reversed.shape(), (std::vector<size_t>{4, 3, 6}));
+    EXPECT_EQ(reversed.at({0, 0, 0}), array.at({0, 4, 0}));
+    EXPECT_EQ(reversed.at({3, 2, 5}), array.at({3, 0, 5}));
+    EXPECT_EQ(view.slice(2, npy_slice{3, 100}).shape(), (std::vector<size_t>{4, 5, 3}));
+    EXPECT_EQ(view.slice(2, npy_slice{4, 2}).size(), 0);
+    EXPECT_EQ(view.slice(2, npy_slice{4, 2, -1}).at({0, 0, 1}), 3);
+
+    // A range of rows is contiguous.
+    EXPECT_TRUE(view.slice({npy_slice{2, 4}}).contiguous());
+
+    // The writes land in the array.
+    block[{1, 4, 1}] = -1;
+    EXPECT_EQ(array.at({2, 4, 4}), -1);
+
+    try
+    {
+        view.slice(0, npy_slice{0, 4, 0});
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+
+    try
+    {
+        view.slice({npy_slice{}, npy_slice{}, npy_slice{}, npy_slice{}});
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+
+    try
+    {
+        block.at({2, 0, 0});
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+}
+
+TEST(NPYViewTest, SelectTransposeTest)
+{
+    npy_array<double> array{{3, 4, 5}};
+    std::iota(array.begin(), array.end(), 0.0);
+    const npy_array<double>& constant = array;
+
+    npy_view<const double> view{constant};
+
+    npy_view<const double> row = view.select(0, 2);
+    EXPECT_EQ(row.shape(), (std::vector<size_t>{4, 5}));
+    EXPECT_TRUE(row.contiguous());
+    EXPECT_EQ(row.data(), array.data() + 40);
+
+    npy_view<const double> column = view.select(2, 3);
+    EXPECT_EQ(column.shape(), (std::vector<size_t>{3, 4}));
+    EXPECT_EQ(column.at({1, 2}), array.at({1, 2, 3}));
+
+    npy_view<const double> transposed = view.transpose();
+    EXPECT_EQ(transposed.shape(), (std::vector<size_t>{5, 4, 3}));
+    EXPECT_EQ(transposed.at({4, 1, 2}), array.at({2, 1, 4}));
+    EXPECT_FALSE(transposed.contiguous());
+
+    npy_view<const double> permuted = view.transpose({1, 2, 0});
+    EXPECT_EQ(permuted.shape(), (std::vector<size_t>{4, 5, 3}));
+    EXPECT_EQ(permuted.at({3, 1, 2}), array.at({2, 3, 1}));
+
+    try
+    {
+        view.transpose({0, 0, 1});
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+
+    try
+    {
+        view.select(1, 4);
+        FAIL();
+    }
+    catch(const std::out_of_range& e) {}
+
+    try
+    {
+        view.select(3, 0);
+        FAIL();
+    }
+    catch(const std::invalid_argument& e) {}
+}
+
+TEST(NPYViewTest, CopyTest)
+{
+    npy_array<int> array{{6, 7, 8}};
+    std::iota(array.begin(), array.end(), 0);
+    npy_view<int> view{array};
+
+    // Contiguous, blocks of inner dimensions, single elements, and backwards.
+    std::vector<npy_view<int>> views{
+        view,
+        view.slice({npy_slice{1, 5}}),
+        view.slice({npy_slice{1, 5, 2}}),
+        view.slice({npy_slice{}, npy_slice{2, 6}}),
+        view.slice({npy_slice{}, npy_slice{}, npy_slice{1, 7, 3}}),
+        view.slice({npy_slice{npy_slice_none, npy_slice_none, -1}, npy_slice{3, 4}}),
+        view.transpose({2, 0, 1}),
+        view.select(1, 3).transpose(),
+        view.slice(0, npy_slice{3, 3})
+    };
+
+    for(const npy_view<int>& source : views)
+    {
+        npy_array<int> copied = source.copy();
+        ASSERT_EQ(copied.shape(), source.shape());
+        EXPECT_FALSE(copied.fortran_order());
+
+        npy_view<int> copied_view{copied};
+        EXPECT_TRUE(copied_view.contiguous());
+
+        // Compare the elements in C order, whatever the number of axes.
+        std::vector<size_t> indexes(source.shape().size(), 0);
+        for(size_t i = 0; i < copied.size(); i++)
+        {
+            ptrdiff_t offset = source.offset();
+            for(size_t axis = 0; axis < indexes.size(); axis++)
+            {
+                offset += static_cast<ptrdiff_t>(indexes[axis]) * source.strides()[axis];
+            }
+
+            EXPECT_EQ(copied[i], array[offset]);
+
+            for(size_t axis = indexes.size(); axis > 0 && ++indexes[axis - 1] == source.shape()[axis - 1]; axis--)
+            {
+                indexes[axis - 1] = 0;
+            }
+        }
+    }
+
+    // A Fortran-ordered array is viewed with its own strides, and copied in C order.
+    npz_archive archive{"./test_resources/stored.npz"};
+    npy_array<int> fortran = archive.load<int>("fortran");
+    npy_array<int> c_order = archive.load<int>("fortran", npy_array_mode::load_c_order);
+
+    npy_array<int> copied = npy_view<int>{fortran}.copy();
+    EXPECT_EQ(copied.shape(), c_order.shape());
+    EXPECT_TRUE(std::equal(copied.cbegin(), copied.cend(), c_order.cbegin()));
+}
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
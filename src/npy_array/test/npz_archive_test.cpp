@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "npy_array/npz_archive.h"
+#include "npy_array/npz_writer.h"
+
+TEST(NPZArchiveTest, MembersTest)
+{
+    for(const std::string archive_path : {"./test_resources/stored.npz", "./test_resources/compressed.npz"})
+    {
+        npz_archive archive{archive_path};
+
+        // The text member of the stored archive is not an array and it is ignored.
+        std::vector<std::string> names{{"weights", "indices", "big", "fortran"}};
+        EXPECT_EQ(archive.names(), names);
+        EXPECT_EQ(archive.size(), 4);
+        EXPECT_TRUE(archive.contains("big"));
+        EXPECT_FALSE(archive.contains("readme"));
+
+        std::vector<size_t> shape{{3, 4}};
+        EXPECT_EQ(archive.member("weights").header.shape(), shape);
+        EXPECT_EQ(archive.member("weights").header.dtype(), npy_dtype::float_32());
+        EXPECT_EQ(archive.member("big").header.dtype().str(), ">i2");
+        EXPECT_TRUE(archive.member("fortran").header.fortran_order());
+        EXPECT_EQ(archive.member("indices").compressed, archive_path == "./test_resources/compressed.npz");
+
+        try
+        {
+            archive.member("missing");
+            FAIL();
+        }
+        catch(const std::out_of_range& e) {}
+    }
+}
+
+TEST(NPZArchiveTest, LoadTest)
+{
+    for(const std::string archive_path : {"./test_resources/stored.npz", "./test_resources/compressed.npz"})
+    {
+        npz_archive archive{archive_path};
+
+        npy_array<float> weights = archive.load<float>("weights");
+        EXPECT_FALSE(weights.mapped());
+        EXPECT_FLOAT_EQ(weights.at({2, 3}), 5.5f);
+
+        npy_array<long> indices = archive.load<long>("indices", npy_array_mode::map_read_only);
+        for(size_t i = 0; i < indices.size(); i++)
+        {
+            EXPECT_EQ(indices[i], static_cast<long>(i));
+        }
+
+        npy_array<short> big = archive.load<short>("big");
+        EXPECT_EQ(big.dtype(), npy_dtype::int_16());
+        EXPECT_EQ(big.at({1, 2}), 2);
+
+        npy_array<int> fortran = archive.load<int>("fortran");
+        EXPECT_TRUE(fortran.fortran_order());
+        EXPECT_EQ(fortran.at({1, 2}), 12);
+
+        npy_array<int> c_order = archive.load<int>("fortran", npy_array_mode::load_c_order);
+        EXPECT_FALSE(c_order.fortran_order());
+        EXPECT_EQ(c_order[1 * 3 + 2], 12);
+
+        try
+        {
+            archive.load<double>("weights");
+            FAIL();
+        }
+        catch(const npy_array_exception& e)
+        {
+            EXPECT_EQ(e.exception_type(), npy_array_exception_type::ill_formed_header);
+        }
+
+        try
+        {
+            archive.load<float>("weights", npy_array_mode::map_read_write);
+            FAIL();
+        }
+        catch(const npy_array_exception& e)
+        {
+            EXPECT_EQ(e.exception_type(), npy_array_exception_type::input_output_error);
+        }
+    }
+}
+
+TEST(NPZArchiveTest, ZeroCopyTest)
+{
+    npy_array<float> weights = npz_archive{"./test_resources/stored.npz"}.load<float>("weights", npy_array_mode::map_read_only);
+
+    // The stored member is aligned, so it refers to the mapping, which outlives the archive.
+    EXPECT_TRUE(weights.mapped());
+    EXPECT_FLOAT_EQ(weights.at({1, 1}), 2.5f);
+
+    npy_array<float> compressed_weights = npz_archive{"./test_resources/compressed.npz"}.load<float>("weights", npy_array_mode::map_read_only);
+    EXPECT_FALSE(compressed_weights.mapped());
+    EXPECT_TRUE(std::equal(weights.cbegin(), weights.cend(), compressed_weights.cbegin()));
+
+    // The payloads copied in memory are allocated by the given allocator.
+    npy_array<float, npy_aligned_allocator<float>> aligned_weights =
+        npz_archive{"./test_resources/compressed.npz"}.load<float>("weights", npy_array_mode::load_in_memory, npy_aligned_allocator<float>{});
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned_weights.data()) % 64, 0);
+    EXPECT_TRUE(std::equal(weights.cbegin(), weights.cend(), aligned_weights.cbegin()));
+
+    npy_array<float, npy_aligned_allocator<float>> mapped_weights =
+        npz_archive{"./test_resources/stored.npz"}.load<float>("weights", npy_array_mode::map_read_only, npy_aligned_allocator<float>{});
+    EXPECT_TRUE(mapped_weights.mapped());
+    EXPECT_TRUE(std::equal(weights.cbegin(), weights.cend(), mapped_weights.cbegin()));
+}
+
+TEST(NPZArchiveTest, InvalidArchiveTest)
+{
+    try
+    {
+        npz_archive{"./test_resources/10.npy"};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::invalid_archive);
+    }
+
+    // Corrupt the deflate stream of the first member of a copy of the compressed archive.
+    std::ifstream archive_file{"./test_resources/compressed.npz", std::ios_base::binary};
+    std::string archive_bytes{std::istreambuf_iterator<char>{archive_file}, std::istreambuf_iterator<char>{}};
+    archive_file.close();
+
+    for(size_t i = 80; i < 100; i++)
+    {
+        archive_bytes[i] = '\xff';
+    }
+
+    std::ofstream corrupted_file{"./test_resources/corrupted.npz", std::ios_base::binary};
+    corrupted_file.write(archive_bytes.data(), archive_bytes.size());
+    corrupted_file.close();
+
+    try
+    {
+        npz_archive archive{"./test_resources/corrupted.npz"};
+        archive.load<float>("weights");
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_NE(e.exception_type(), npy_array_exception_type::generic);
+    }
+
+    // A stored member whose payload does not match its CRC, and one whose header claims more bytes than it holds.
+    std::ifstream stored_file{"./test_resources/stored.npz", std::ios_base::binary};
+    std::string stored_bytes{std::istreambuf_iterator<char>{stored_file}, std::istreambuf_iterator<char>{}};
+    stored_file.close();
+
+    const npz_member weights = npz_archive{"./test_resources/stored.npz"}.member("weights");
+    std::string flipped_bytes{stored_bytes};
+    flipped_bytes[weights.data_offset + weights.uncompressed_size - 1] ^= 0x1;
+
+    corrupted_file.open("./test_resources/corrupted.npz", std::ios_base::binary);
+    corrupted_file.write(flipped_bytes.data(), flipped_bytes.size());
+    corrupted_file.close();
+
+    try
+    {
+        npz_archive{"./test_resources/corrupted.npz"}.load<float>("weights");
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::invalid_archive);
+    }
+
+    std::string truncated_bytes{stored_bytes};
+    truncated_bytes.replace(truncated_bytes.find("'shape': (3, 4)"), 15, "'shape': (9, 4)");
+
+    corrupted_file.open("./test_resources/corrupted.npz", std::ios_base::binary);
+    corrupted_file.write(truncated_bytes.data(), truncated_bytes.size());
+    corrupted_file.close();
+
+    try
+    {
+        npz_archive{"./test_resources/corrupted.npz"};
+        FAIL();
+    }
+    catch(const npy_array_exception& e)
+    {
+        EXPECT_EQ(e.exception_type(), npy_array_exception_type::invalid_archive);
+    }
+
+    std::remove("./test_resources/corrupted.npz");
+}
+
+TEST(NPZArchiveTest, WriterTest)
+{
+    npy_array<double> matrix{{250, 400}};
+    for(size_t i = 0; i < matrix.size(); i++)
+    {
+        matrix[i] = static_cast<double>(i % 1000) * 0.25;
+    }
+
+    npy_array<int> fortran = npz_archive{"./test_resources/stored.npz"}.load<int>("fortran");
+
+    for(npz_compression compression : {npz_compression::npz_stored, npz_compression::npz_deflated})
+    {
+        {
+            // Small chunks, so that the matrix is split in several batches of chunks.
+            npz_writer writer{"./test_resources/written.npz", compression, 6, npy_thread_pool::shared(), 1000};
+            writer.add("matrix", matrix);
+            writer.add("fortran", fortran);
+
+            EXPECT_EQ(writer.size(), 2);
+
+            try
+            {
+                writer.add("matrix", matrix);
+                FAIL();
+            }
+            catch(const std::invalid_argument& e) {}
+
+            writer.close();
+            EXPECT_FALSE(writer.is_open());
+        }
+
+        npz_archive archive{"./test_resources/written.npz"};
+        std::vector<std::string> names{"matrix", "fortran"};
+        EXPECT_EQ(archive.names(), names);
+        EXPECT_EQ(archive.member("matrix").compressed, compression == npz_compression::npz_deflated);
+
+        npy_array<double> read_matrix = archive.load<double>("matrix");
+        EXPECT_EQ(read_matrix.shape(), matrix.shape());
+        EXPECT_TRUE(std::equal(read_matrix.cbegin(), read_matrix.cend(), matrix.cbegin()));
+
+        if(compression == npz_compression::npz_deflated)
+        {
+            EXPECT_LT(archive.member("matrix").compressed_size, matrix.byte_size() / 4);
+        }
+
+        npy_array<int> read_fortran = archive.load<int>("fortran");
+        EXPECT_TRUE(read_fortran.fortran_order());
+        EXPECT_EQ(read_fortran.at({1, 2}), 12);
+
+        // Every central directory header is made by a Unix host, whose external attributes are a Unix mode.
+        std::ifstream written_file{"./test_resources/written.npz", std::ios_base::binary};
+        std::string written_bytes{std::istreambuf_iterator<char>{written_file}, std::istreambuf_iterator<char>{}};
+        size_t headers = 0;
+
+        for(size_t position = written_bytes.find("PK\x01\x02"); position != std::string::npos; position = written_bytes.find("PK\x01\x02", position + 1))
+        {
+            EXPECT_EQ(static_cast<uint8_t>(written_bytes[position + 5]), 3);
+            headers++;
+        }
+
+        EXPECT_EQ(headers, 2);
+    }
+
+    // The destructor writes the central directory of an archive left open.
+    {
+        npz_writer writer{"./test_resources/written.npz", npz_compression::npz_deflated};
+        writer.add("fortran", fortran);
+    }
+
+    EXPECT_EQ(npz_archive{"./test_resources/written.npz"}.load<int>("fortran").at({0, 1}), 1);
+
+    std::remove("./test_resources/written.npz");
+}
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}